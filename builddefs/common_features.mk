@@ -58,6 +58,9 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
         else ifeq ($(strip $(AUDIO_DRIVER)), pwm_hardware)
             OPT_DEFS += -DAUDIO_DRIVER_PWM
         endif
+    else ifeq ($(strip $(AUDIO_DRIVER)), render)
+        # host side renderer of the dac_additive sample stream, for tests
+        OPT_DEFS += -DAUDIO_DRIVER_DAC
     else
         # fallback for all other platforms is pwm
         AUDIO_DRIVER ?= pwm_hardware
@@ -72,6 +75,9 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
     SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/audio_$(strip $(AUDIO_DRIVER)).c
     SRC += $(QUANTUM_DIR)/audio/voices.c
     SRC += $(QUANTUM_DIR)/audio/luts.c
+    ifneq ($(filter dac_additive render,$(strip $(AUDIO_DRIVER))),)
+        SRC += $(QUANTUM_DIR)/audio/audio_synth.c
+    endif
 endif
 
 ifeq ($(strip $(SEQUENCER_ENABLE)), yes)
@@ -124,38 +130,48 @@ VALID_POINTING_DEVICE_DRIVER_TYPES := adns5050 adns9800 analog_joystick azoteq_i
 ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
     ifeq ($(filter $(POINTING_DEVICE_DRIVER),$(VALID_POINTING_DEVICE_DRIVER_TYPES)),)
         $(call CATASTROPHIC_ERROR,Invalid POINTING_DEVICE_DRIVER,POINTING_DEVICE_DRIVER="$(POINTING_DEVICE_DRIVER)" is not a valid pointing device type)
+    else ifneq ($(filter-out $(VALID_POINTING_DEVICE_DRIVER_TYPES),$(POINTING_DEVICE_DRIVER)),)
+        $(call CATASTROPHIC_ERROR,Invalid POINTING_DEVICE_DRIVER,POINTING_DEVICE_DRIVER="$(filter-out $(VALID_POINTING_DEVICE_DRIVER_TYPES),$(POINTING_DEVICE_DRIVER))" is not a valid pointing device type)
     else
         OPT_DEFS += -DPOINTING_DEVICE_ENABLE
         MOUSE_ENABLE := yes
         VPATH += $(QUANTUM_DIR)/pointing_device
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_drivers.c
+        SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_sensors.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_auto_mouse.c
-        ifneq ($(strip $(POINTING_DEVICE_DRIVER)), custom)
-            SRC += drivers/sensors/$(strip $(POINTING_DEVICE_DRIVER)).c
-            OPT_DEFS += -DPOINTING_DEVICE_DRIVER_$(strip $(shell echo $(POINTING_DEVICE_DRIVER) | tr '[:lower:]' '[:upper:]'))
+        # Several drivers can be listed, their sensors are then combined through the sensor table
+        POINTING_DEVICE_SENSOR_DRIVERS := $(sort $(filter-out custom,$(POINTING_DEVICE_DRIVER)))
+        SRC += $(addprefix drivers/sensors/,$(addsuffix .c,$(POINTING_DEVICE_SENSOR_DRIVERS)))
+        OPT_DEFS += $(addprefix -DPOINTING_DEVICE_DRIVER_,$(shell echo $(POINTING_DEVICE_SENSOR_DRIVERS) | tr '[:lower:]' '[:upper:]'))
+        OPT_DEFS += $(addprefix -DPOINTING_DEVICE_DRIVER_,$(sort $(POINTING_DEVICE_DRIVER)))
+        ifneq ($(words $(sort $(POINTING_DEVICE_DRIVER))), 1)
+            OPT_DEFS += -DPOINTING_DEVICE_MULTIPLE_DRIVERS
+        endif
+        ifeq ($(strip $(POINTING_DEVICE_MOTION_INTERRUPT)), yes)
+            OPT_DEFS += -DPOINTING_DEVICE_MOTION_INTERRUPT
+            # Platforms without a backend sample the sensor from the main loop
+            ifneq ($(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/pointing_device_motion.c),)
+                SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/pointing_device_motion.c
+            endif
         endif
-        OPT_DEFS += -DPOINTING_DEVICE_DRIVER_$(strip $(POINTING_DEVICE_DRIVER))
-        ifeq ($(strip $(POINTING_DEVICE_DRIVER)), adns9800)
+        ifneq ($(filter adns9800 cirque_pinnacle_spi pmw3360 pmw3389,$(POINTING_DEVICE_DRIVER)),)
             SPI_DRIVER_REQUIRED = yes
-        else ifeq ($(strip $(POINTING_DEVICE_DRIVER)), analog_joystick)
-            ANALOG_DRIVER_REQUIRED = yes
-        else ifeq ($(strip $(POINTING_DEVICE_DRIVER)), azoteq_iqs5xx)
-            I2C_DRIVER_REQUIRED = yes
-        else ifeq ($(strip $(POINTING_DEVICE_DRIVER)), cirque_pinnacle_i2c)
+        endif
+        ifneq ($(filter azoteq_iqs5xx cirque_pinnacle_i2c pimoroni_trackball,$(POINTING_DEVICE_DRIVER)),)
             I2C_DRIVER_REQUIRED = yes
-            SRC += drivers/sensors/cirque_pinnacle.c
-            SRC += drivers/sensors/cirque_pinnacle_gestures.c
+        endif
+        ifneq ($(filter analog_joystick,$(POINTING_DEVICE_DRIVER)),)
+            ANALOG_DRIVER_REQUIRED = yes
+        endif
+        ifneq ($(filter azoteq_iqs5xx cirque_pinnacle_i2c cirque_pinnacle_spi,$(POINTING_DEVICE_DRIVER)),)
             SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_gestures.c
-        else ifeq ($(strip $(POINTING_DEVICE_DRIVER)), cirque_pinnacle_spi)
-            SPI_DRIVER_REQUIRED = yes
+        endif
+        ifneq ($(filter cirque_pinnacle_i2c cirque_pinnacle_spi,$(POINTING_DEVICE_DRIVER)),)
             SRC += drivers/sensors/cirque_pinnacle.c
             SRC += drivers/sensors/cirque_pinnacle_gestures.c
-            SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_gestures.c
-        else ifeq ($(strip $(POINTING_DEVICE_DRIVER)), pimoroni_trackball)
-            I2C_DRIVER_REQUIRED = yes
-        else ifneq ($(filter $(strip $(POINTING_DEVICE_DRIVER)),pmw3360 pmw3389),)
-            SPI_DRIVER_REQUIRED = yes
+        endif
+        ifneq ($(filter pmw3360 pmw3389,$(POINTING_DEVICE_DRIVER)),)
             SRC += drivers/sensors/pmw33xx_common.c
         endif
     endif
@@ -188,11 +204,19 @@ else
     OPT_DEFS += -DEEPROM_DRIVER -DEEPROM_I2C
     I2C_DRIVER_REQUIRED = yes
     SRC += eeprom_driver.c eeprom_i2c.c
+    ifeq ($(strip $(EEPROM_CACHE_ENABLE)), yes)
+      OPT_DEFS += -DEEPROM_CACHE_ENABLE
+      SRC += eeprom_page_cache.c
+    endif
   else ifeq ($(strip $(EEPROM_DRIVER)), spi)
     # External SPI EEPROM implementation
     OPT_DEFS += -DEEPROM_DRIVER -DEEPROM_SPI
     SPI_DRIVER_REQUIRED = yes
     SRC += eeprom_driver.c eeprom_spi.c
+    ifeq ($(strip $(EEPROM_CACHE_ENABLE)), yes)
+      OPT_DEFS += -DEEPROM_CACHE_ENABLE
+      SRC += eeprom_page_cache.c
+    endif
   else ifeq ($(strip $(EEPROM_DRIVER)), legacy_stm32_flash)
     # STM32 Emulated EEPROM, backed by MCU flash (soon to be deprecated)
     OPT_DEFS += -DEEPROM_DRIVER -DEEPROM_LEGACY_EMULATED_FLASH
@@ -315,6 +339,13 @@ ifeq ($(strip $(RGBLIGHT_ENABLE)), yes)
         SRC += $(QUANTUM_DIR)/rgblight/rgblight.c
         CIE1931_CURVE := yes
         RGB_KEYCODES_ENABLE := yes
+        ifeq ($(strip $(RGBLIGHT_ANIMATION_TIMER)), yes)
+            OPT_DEFS += -DRGBLIGHT_ANIMATION_TIMER
+            # Platforms without a backend check the animation on every main loop iteration
+            ifneq ($(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/rgblight_animation_timer.c),)
+                SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/rgblight_animation_timer.c
+            endif
+        endif
     endif
 
     ifeq ($(strip $(RGBLIGHT_DRIVER)), ws2812)
@@ -923,6 +954,9 @@ ifeq ($(strip $(WS2812_DRIVER_REQUIRED)), yes)
         ifeq ($(strip $(WS2812_DRIVER)), pwm)
             OPT_DEFS += -DSTM32_DMA_REQUIRED=TRUE
         endif
+        ifneq ($(filter $(WS2812_DRIVER),bitbang pwm spi),)
+            SRC += ws2812_encode.c
+        endif
     endif
 
     # add extra deps
@@ -941,6 +975,18 @@ ifeq ($(strip $(ANALOG_DRIVER_REQUIRED)), yes)
     QUANTUM_LIB_SRC += analog.c
 endif
 
+ifeq ($(strip $(I2C_QUEUE_ENABLE)), yes)
+    I2C_DRIVER_REQUIRED = yes
+    OPT_DEFS += -DI2C_QUEUE_ENABLE
+    QUANTUM_LIB_SRC += i2c_queue.c
+endif
+
+ifeq ($(strip $(SPI_QUEUE_ENABLE)), yes)
+    SPI_DRIVER_REQUIRED = yes
+    OPT_DEFS += -DSPI_QUEUE_ENABLE
+    QUANTUM_LIB_SRC += spi_queue.c
+endif
+
 ifeq ($(strip $(I2C_DRIVER_REQUIRED)), yes)
     OPT_DEFS += -DHAL_USE_I2C=TRUE
     QUANTUM_LIB_SRC += i2c_master.c
@@ -0,0 +1,88 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Ring buffer shared by the I2C and SPI transfer queues.
+
+    Jobs move from pending (tail) to executing (active) to completed
+    (complete). The submitting thread owns tail and complete, the backend owns
+    active, so no locking is required on a single core. One slot is always left
+    free so that a full queue can be told apart from an empty one by the
+    backend, which only compares indices.
+
+    The submitting thread fills the slot returned by bus_queue_reserve() and
+    then publishes it; the backend executes the job returned by
+    bus_queue_next_pending() and then finishes it; the submitting thread reports
+    the job returned by bus_queue_next_complete() and then releases its slot.
+*/
+
+typedef struct bus_queue_t {
+    void             *jobs;     // slots jobs of job_size bytes each
+    uint16_t          job_size; // size of a single job
+    uint8_t           slots;    // one more than the number of jobs which can be pending at once
+    volatile uint8_t  tail;
+    volatile uint8_t  active;
+    volatile uint8_t  complete;
+    volatile uint16_t count; // jobs submitted and not yet released
+} bus_queue_t;
+
+/* Initialiser for a queue kept in the array storage, which must have one more slot than jobs that can be pending */
+#define BUS_QUEUE_INIT(storage) \
+    { .jobs = (storage), .job_size = sizeof((storage)[0]), .slots = sizeof(storage) / sizeof((storage)[0]) }
+
+// Ensures job contents are written before the index publishing them
+#define BUS_QUEUE_PUBLISH() __asm__ volatile("" ::: "memory")
+
+static inline uint8_t bus_queue_next_index(const bus_queue_t *queue, uint8_t index) {
+    return (index + 1) % queue->slots;
+}
+
+static inline void *bus_queue_slot(const bus_queue_t *queue, uint8_t index) {
+    return (uint8_t *)queue->jobs + (uint16_t)index * queue->job_size;
+}
+
+static inline bool bus_queue_is_full(const bus_queue_t *queue) {
+    return queue->count == queue->slots - 1;
+}
+
+static inline bool bus_queue_is_empty(const bus_queue_t *queue) {
+    return queue->count == 0;
+}
+
+/* Returns the slot to fill with the next job, or NULL if the queue is full -- submitting thread only */
+static inline void *bus_queue_reserve(bus_queue_t *queue) {
+    return bus_queue_is_full(queue) ? NULL : bus_queue_slot(queue, queue->tail);
+}
+
+/* Hands the job filled in by bus_queue_reserve() to the backend -- submitting thread only */
+static inline void bus_queue_publish(bus_queue_t *queue) {
+    BUS_QUEUE_PUBLISH();
+    queue->tail = bus_queue_next_index(queue, queue->tail);
+    queue->count++;
+}
+
+/* Returns the oldest job which has not been executed, or NULL if there is none -- backend only */
+static inline void *bus_queue_next_pending(const bus_queue_t *queue) {
+    return queue->active == queue->tail ? NULL : bus_queue_slot(queue, queue->active);
+}
+
+/* Marks the job returned by bus_queue_next_pending() as completed -- backend only */
+static inline void bus_queue_finish(bus_queue_t *queue) {
+    BUS_QUEUE_PUBLISH();
+    queue->active = bus_queue_next_index(queue, queue->active);
+}
+
+/* Returns the oldest completed job which has not been released, or NULL if there is none -- submitting thread only */
+static inline void *bus_queue_next_complete(const bus_queue_t *queue) {
+    return queue->complete == queue->active ? NULL : bus_queue_slot(queue, queue->complete);
+}
+
+/* Frees the slot of the job returned by bus_queue_next_complete() -- submitting thread only */
+static inline void bus_queue_release(bus_queue_t *queue) {
+    queue->complete = bus_queue_next_index(queue, queue->complete);
+    queue->count--;
+}
@@ -15,6 +15,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #if defined(EXTERNAL_EEPROM_WP_PIN)
 #    include "gpio.h"
@@ -34,17 +35,29 @@
 */
 
 #include "wait.h"
+#include "timer.h"
 #include "i2c_master.h"
 #include "eeprom.h"
+#include "eeprom_driver.h"
 #include "eeprom_i2c.h"
+#ifdef EEPROM_CACHE_ENABLE
+#    include "eeprom_page_cache.h"
+#endif
 
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif // DEBUG_EEPROM_OUTPUT
 
+#if defined(EEPROM_CACHE_ENABLE) && !defined(EXTERNAL_EEPROM_WP_PIN) && (EXTERNAL_EEPROM_WRITE_TIME > 0)
+// Page cache write-backs do not wait for the write cycle, as long as there is no WP pin to release. The wait is
+// deferred until the next transaction with the EEPROM, or until eeprom_driver_flush() commits the data.
+#    define EXTERNAL_EEPROM_DEFERRED_WRITE_WAIT
+static bool     write_cycle_pending = false;
+static uint32_t write_cycle_start   = 0;
+#endif
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -62,28 +75,25 @@ void eeprom_driver_init(void) {
 #endif
 }
 
-void eeprom_driver_erase(void) {
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    uint32_t start = timer_read32();
-#endif
-
-    uint8_t buf[EXTERNAL_EEPROM_PAGE_SIZE];
-    memset(buf, 0x00, EXTERNAL_EEPROM_PAGE_SIZE);
-    for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
-        eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
+static void eeprom_i2c_wait_for_write_cycle(void) {
+#ifdef EXTERNAL_EEPROM_DEFERRED_WRITE_WAIT
+    if (write_cycle_pending) {
+        uint32_t elapsed = timer_elapsed32(write_cycle_start);
+        if (elapsed < EXTERNAL_EEPROM_WRITE_TIME) {
+            wait_ms(EXTERNAL_EEPROM_WRITE_TIME - elapsed);
+        }
+        write_cycle_pending = false;
     }
-
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
 #endif
 }
 
-void eeprom_read_block(void *buf, const void *addr, size_t len) {
+static void eeprom_i2c_read(void *buf, uintptr_t addr, size_t len) {
     uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
-    fill_target_address(complete_packet, addr);
+    eeprom_i2c_wait_for_write_cycle();
+    fill_target_address(complete_packet, (const void *)addr);
 
-    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
-    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
+    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS(addr), buf, len, 100);
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
@@ -94,10 +104,10 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 #endif // DEBUG_EEPROM_OUTPUT
 }
 
-void eeprom_write_block(const void *buf, void *addr, size_t len) {
+static void eeprom_i2c_write(const void *buf, uintptr_t addr, size_t len) {
     uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
     uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+    uintptr_t target_addr = addr;
 
 #if defined(EXTERNAL_EEPROM_WP_PIN)
     setPinOutput(EXTERNAL_EEPROM_WP_PIN);
@@ -124,8 +134,14 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
         dprintf("\n");
 #endif // DEBUG_EEPROM_OUTPUT
 
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
+        eeprom_i2c_wait_for_write_cycle();
+        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
+#ifdef EXTERNAL_EEPROM_DEFERRED_WRITE_WAIT
+        write_cycle_pending = true;
+        write_cycle_start   = timer_read32();
+#else
         wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+#endif
 
         read_buf += write_length;
         target_addr += write_length;
@@ -138,3 +154,59 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
     setPinInputHigh(EXTERNAL_EEPROM_WP_PIN);
 #endif
 }
+
+void eeprom_driver_erase(void) {
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    uint32_t start = timer_read32();
+#endif
+
+#ifdef EEPROM_CACHE_ENABLE
+    eeprom_page_cache_invalidate();
+#endif
+
+    uint8_t buf[EXTERNAL_EEPROM_PAGE_SIZE];
+    memset(buf, 0x00, EXTERNAL_EEPROM_PAGE_SIZE);
+    for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
+        eeprom_i2c_write(buf, addr, EXTERNAL_EEPROM_PAGE_SIZE);
+    }
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
+#endif
+}
+
+#ifdef EEPROM_CACHE_ENABLE
+void eeprom_page_cache_backend_read(uintptr_t addr, uint8_t *buf, size_t len) {
+    eeprom_i2c_read(buf, addr, len);
+}
+
+void eeprom_page_cache_backend_write(uintptr_t addr, const uint8_t *buf, size_t len) {
+    eeprom_i2c_write(buf, addr, len);
+}
+
+void eeprom_driver_flush(void) {
+    eeprom_page_cache_flush();
+    // The pending state is lost on reset, so the last write cycle has to have ended once this returns
+    eeprom_i2c_wait_for_write_cycle();
+}
+
+void eeprom_driver_task(void) {
+    eeprom_page_cache_task();
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    eeprom_page_cache_read(buf, (uintptr_t)addr, len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    eeprom_page_cache_write(buf, (uintptr_t)addr, len);
+}
+#else
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    eeprom_i2c_read(buf, (uintptr_t)addr, len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    eeprom_i2c_write(buf, (uintptr_t)addr, len);
+}
+#endif // EEPROM_CACHE_ENABLE
@@ -0,0 +1,149 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <stdbool.h>
+#include <string.h>
+#include "timer.h"
+#include "eeprom_page_cache.h"
+
+#if defined(EEPROM_I2C)
+#    include "eeprom_i2c.h"
+#elif defined(EEPROM_SPI)
+#    include "eeprom_spi.h"
+#endif
+
+#if !defined(EXTERNAL_EEPROM_PAGE_SIZE) || !defined(EXTERNAL_EEPROM_BYTE_COUNT)
+#    error EXTERNAL_EEPROM_PAGE_SIZE and EXTERNAL_EEPROM_BYTE_COUNT must be defined to use the EEPROM page cache
+#endif
+
+#define CACHE_PAGE_INVALID UINT32_MAX
+
+typedef struct eeprom_cache_page_t {
+    uint32_t page;  // index of the EEPROM page held, or CACHE_PAGE_INVALID
+    uint8_t  age;   // 0 is most recently used
+    bool     dirty; // cached data differs from the EEPROM
+    uint8_t  data[EXTERNAL_EEPROM_PAGE_SIZE];
+} eeprom_cache_page_t;
+
+static eeprom_cache_page_t cache[EXTERNAL_EEPROM_CACHE_PAGE_COUNT];
+static bool                cache_initialised = false;
+static bool                cache_dirty       = false;
+static uint32_t            last_write        = 0;
+
+static void eeprom_page_cache_init(void) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGE_COUNT; ++i) {
+        cache[i].page  = CACHE_PAGE_INVALID;
+        cache[i].age   = i;
+        cache[i].dirty = false;
+    }
+    cache_dirty       = false;
+    cache_initialised = true;
+}
+
+static void eeprom_page_cache_touch(eeprom_cache_page_t *entry) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGE_COUNT; ++i) {
+        if (cache[i].age < entry->age) {
+            cache[i].age++;
+        }
+    }
+    entry->age = 0;
+}
+
+static void eeprom_page_cache_writeback(eeprom_cache_page_t *entry) {
+    if (entry->dirty) {
+        eeprom_page_cache_backend_write(entry->page * EXTERNAL_EEPROM_PAGE_SIZE, entry->data, EXTERNAL_EEPROM_PAGE_SIZE);
+        entry->dirty = false;
+    }
+}
+
+/**
+ * Returns the cache entry for the requested page, loading it from the EEPROM (and evicting the least recently used
+ * entry) if required. A full overwrite of the page skips the read from the EEPROM.
+ */
+static eeprom_cache_page_t *eeprom_page_cache_get(uint32_t page, bool full_overwrite) {
+    if (!cache_initialised) {
+        eeprom_page_cache_init();
+    }
+
+    eeprom_cache_page_t *victim = &cache[0];
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGE_COUNT; ++i) {
+        if (cache[i].page == page) {
+            eeprom_page_cache_touch(&cache[i]);
+            return &cache[i];
+        }
+        if (cache[i].age > victim->age) {
+            victim = &cache[i];
+        }
+    }
+
+    eeprom_page_cache_writeback(victim);
+    if (!full_overwrite) {
+        eeprom_page_cache_backend_read(page * EXTERNAL_EEPROM_PAGE_SIZE, victim->data, EXTERNAL_EEPROM_PAGE_SIZE);
+    }
+    victim->page  = page;
+    victim->dirty = full_overwrite; // contents are stale until the caller overwrites them
+    eeprom_page_cache_touch(victim);
+    return victim;
+}
+
+void eeprom_page_cache_read(void *buf, uintptr_t addr, size_t len) {
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0) {
+        uint32_t page        = addr / EXTERNAL_EEPROM_PAGE_SIZE;
+        size_t   page_offset = addr % EXTERNAL_EEPROM_PAGE_SIZE;
+        size_t   this_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        if (this_length > len) {
+            this_length = len;
+        }
+
+        eeprom_cache_page_t *entry = eeprom_page_cache_get(page, false);
+        memcpy(p, &entry->data[page_offset], this_length);
+
+        p += this_length;
+        addr += this_length;
+        len -= this_length;
+    }
+}
+
+void eeprom_page_cache_write(const void *buf, uintptr_t addr, size_t len) {
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        uint32_t page        = addr / EXTERNAL_EEPROM_PAGE_SIZE;
+        size_t   page_offset = addr % EXTERNAL_EEPROM_PAGE_SIZE;
+        size_t   this_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        if (this_length > len) {
+            this_length = len;
+        }
+
+        eeprom_cache_page_t *entry = eeprom_page_cache_get(page, this_length == EXTERNAL_EEPROM_PAGE_SIZE);
+        if (entry->dirty || memcmp(&entry->data[page_offset], p, this_length) != 0) {
+            memcpy(&entry->data[page_offset], p, this_length);
+            entry->dirty = true;
+            cache_dirty  = true;
+            last_write   = timer_read32();
+        }
+
+        p += this_length;
+        addr += this_length;
+        len -= this_length;
+    }
+}
+
+void eeprom_page_cache_flush(void) {
+    if (!cache_dirty) {
+        return;
+    }
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_PAGE_COUNT; ++i) {
+        eeprom_page_cache_writeback(&cache[i]);
+    }
+    cache_dirty = false;
+}
+
+void eeprom_page_cache_invalidate(void) {
+    eeprom_page_cache_init();
+}
+
+void eeprom_page_cache_task(void) {
+    if (cache_dirty && timer_elapsed32(last_write) >= EXTERNAL_EEPROM_CACHE_FLUSH_DELAY) {
+        eeprom_page_cache_flush();
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+    Write-back page cache for external EEPROM drivers.
+
+    Reads fetch the entire EEPROM page containing the requested data, so that
+    subsequent accesses to neighbouring addresses are served from RAM. Writes
+    only update the cached copy of the page, which is marked dirty and written
+    back to the device as a single page-aligned burst when:
+        - the page is evicted to make room for another page,
+        - no writes have occurred for EXTERNAL_EEPROM_CACHE_FLUSH_DELAY ms,
+        - eeprom_driver_flush() is invoked, such as during shutdown.
+*/
+
+/*
+    The number of EEPROM pages held in RAM. Each page consumes
+    EXTERNAL_EEPROM_PAGE_SIZE bytes plus a few bytes of bookkeeping.
+*/
+#ifndef EXTERNAL_EEPROM_CACHE_PAGE_COUNT
+#    define EXTERNAL_EEPROM_CACHE_PAGE_COUNT 4
+#endif
+
+/*
+    The time in milliseconds after the last write before dirty pages are
+    written back to the EEPROM.
+*/
+#ifndef EXTERNAL_EEPROM_CACHE_FLUSH_DELAY
+#    define EXTERNAL_EEPROM_CACHE_FLUSH_DELAY 1000
+#endif
+
+void eeprom_page_cache_read(void *buf, uintptr_t addr, size_t len);
+void eeprom_page_cache_write(const void *buf, uintptr_t addr, size_t len);
+void eeprom_page_cache_flush(void);
+void eeprom_page_cache_invalidate(void);
+void eeprom_page_cache_task(void);
+
+// Provided by the underlying EEPROM driver -- addresses are page-aligned, lengths are a single page.
+void eeprom_page_cache_backend_read(uintptr_t addr, uint8_t *buf, size_t len);
+void eeprom_page_cache_backend_write(uintptr_t addr, const uint8_t *buf, size_t len);
@@ -35,7 +35,11 @@
 #include "timer.h"
 #include "spi_master.h"
 #include "eeprom.h"
+#include "eeprom_driver.h"
 #include "eeprom_spi.h"
+#ifdef EEPROM_CACHE_ENABLE
+#    include "eeprom_page_cache.h"
+#endif
 
 #define CMD_WREN 6
 #define CMD_WRDI 4
@@ -92,23 +96,7 @@ void eeprom_driver_init(void) {
     spi_init();
 }
 
-void eeprom_driver_erase(void) {
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    uint32_t start = timer_read32();
-#endif
-
-    uint8_t buf[EXTERNAL_EEPROM_PAGE_SIZE];
-    memset(buf, 0x00, EXTERNAL_EEPROM_PAGE_SIZE);
-    for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
-        eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
-    }
-
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
-#endif
-}
-
-void eeprom_read_block(void *buf, const void *addr, size_t len) {
+static void eeprom_spi_read(void *buf, uintptr_t addr, size_t len) {
     //-------------------------------------------------
     // Wait for the write-in-progress bit to be cleared
     spi_status_t response = spi_eeprom_wait_while_busy(EXTERNAL_EEPROM_SPI_TIMEOUT);
@@ -130,11 +118,11 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     }
 
     spi_write(CMD_READ);
-    spi_eeprom_transmit_address((uintptr_t)addr);
+    spi_eeprom_transmit_address(addr);
     spi_receive(buf, len);
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    dprintf("[EEPROM R] 0x%08lX: ", ((uint32_t)(uintptr_t)addr));
+    dprintf("[EEPROM R] 0x%08lX: ", ((uint32_t)addr));
     for (size_t i = 0; i < len; ++i) {
         dprintf(" %02X", (int)(((uint8_t *)buf)[i]));
     }
@@ -144,10 +132,10 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     spi_stop();
 }
 
-void eeprom_write_block(const void *buf, void *addr, size_t len) {
+static void eeprom_spi_write(const void *buf, uintptr_t addr, size_t len) {
     bool      res;
     uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+    uintptr_t target_addr = addr;
 
     while (len > 0) {
         uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
@@ -215,3 +203,57 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
     spi_write(CMD_WRDI);
     spi_stop();
 }
+
+void eeprom_driver_erase(void) {
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    uint32_t start = timer_read32();
+#endif
+
+#ifdef EEPROM_CACHE_ENABLE
+    eeprom_page_cache_invalidate();
+#endif
+
+    uint8_t buf[EXTERNAL_EEPROM_PAGE_SIZE];
+    memset(buf, 0x00, EXTERNAL_EEPROM_PAGE_SIZE);
+    for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
+        eeprom_spi_write(buf, addr, EXTERNAL_EEPROM_PAGE_SIZE);
+    }
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
+#endif
+}
+
+#ifdef EEPROM_CACHE_ENABLE
+void eeprom_page_cache_backend_read(uintptr_t addr, uint8_t *buf, size_t len) {
+    eeprom_spi_read(buf, addr, len);
+}
+
+void eeprom_page_cache_backend_write(uintptr_t addr, const uint8_t *buf, size_t len) {
+    eeprom_spi_write(buf, addr, len);
+}
+
+void eeprom_driver_flush(void) {
+    eeprom_page_cache_flush();
+}
+
+void eeprom_driver_task(void) {
+    eeprom_page_cache_task();
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    eeprom_page_cache_read(buf, (uintptr_t)addr, len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    eeprom_page_cache_write(buf, (uintptr_t)addr, len);
+}
+#else
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    eeprom_spi_read(buf, (uintptr_t)addr, len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    eeprom_spi_write(buf, (uintptr_t)addr, len);
+}
+#endif // EEPROM_CACHE_ENABLE
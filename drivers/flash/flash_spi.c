@@ -23,6 +23,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "timer.h"
 #include "flash_spi.h"
 #include "spi_master.h"
+#ifdef SPI_QUEUE_ENABLE
+#    include "spi_queue.h"
+#endif
 
 /*
     The time-out time of spi flash transmission.
@@ -63,10 +66,24 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define FLASH_FLAG_WIP 0x01 /* Write in progress bit */
 #define FLASH_FLAG_WEL 0x02 /* Write enable latch bit */
 
+/* FAST_READ requires a single dummy byte after the address. */
+#ifdef EXTERNAL_FLASH_SPI_FAST_READ
+#    define FLASH_CMD_READ_DATA FLASH_CMD_FASTREAD
+#else
+#    define FLASH_CMD_READ_DATA FLASH_CMD_READ
+#endif
+
+/* The largest transfer the spi_master driver can perform in a single call. */
+#define FLASH_SPI_MAX_TRANSFER_LENGTH UINT16_MAX
+
 // #define DEBUG_FLASH_SPI_OUTPUT
 
+static bool spi_flash_start_with_divisor(uint16_t divisor) {
+    return spi_start(EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN, EXTERNAL_FLASH_SPI_LSBFIRST, EXTERNAL_FLASH_SPI_MODE, divisor);
+}
+
 static bool spi_flash_start(void) {
-    return spi_start(EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN, EXTERNAL_FLASH_SPI_LSBFIRST, EXTERNAL_FLASH_SPI_MODE, EXTERNAL_FLASH_SPI_CLOCK_DIVISOR);
+    return spi_flash_start_with_divisor(EXTERNAL_FLASH_SPI_CLOCK_DIVISOR);
 }
 
 static flash_status_t spi_flash_wait_while_busy(void) {
@@ -124,36 +141,100 @@ static flash_status_t spi_flash_write_disable(void) {
     return FLASH_STATUS_SUCCESS;
 }
 
-/* This function is used for read transfer, write transfer and erase transfer. */
-static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t *data, size_t len) {
-    flash_status_t response = FLASH_STATUS_SUCCESS;
-    uint8_t        buffer[EXTERNAL_FLASH_ADDRESS_SIZE + 1];
+/* Fills buffer with the command, address and any dummy byte, returning their length. */
+static uint8_t spi_flash_header(uint8_t *buffer, uint8_t cmd, uint32_t addr) {
+    uint8_t header_length = EXTERNAL_FLASH_ADDRESS_SIZE + 1;
 
     buffer[0] = cmd;
     for (int i = 0; i < EXTERNAL_FLASH_ADDRESS_SIZE; ++i) {
         buffer[EXTERNAL_FLASH_ADDRESS_SIZE - i] = addr & 0xFF;
         addr >>= 8;
     }
+    if (cmd == FLASH_CMD_FASTREAD) {
+        buffer[header_length++] = 0x00; // dummy byte
+    }
+    return header_length;
+}
 
-    bool res = spi_flash_start();
+#ifdef SPI_QUEUE_ENABLE
+_Static_assert(EXTERNAL_FLASH_ADDRESS_SIZE + 2 <= SPI_QUEUE_MAX_HEADER_LENGTH, "SPI_QUEUE_MAX_HEADER_LENGTH is too short for the flash command and address");
+
+static void spi_flash_transaction_complete(spi_status_t status, void *context) {
+    *(spi_status_t *)context = status;
+}
+
+/* This function is used for read transfer, write transfer and erase transfer. Transactions are queued behind those of
+ * other devices on the bus and carried out by the queue's transfer thread, the caller waits for their completion. */
+static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t *data, size_t len) {
+    bool is_read = (cmd == FLASH_CMD_READ || cmd == FLASH_CMD_FASTREAD);
+
+    if (data != NULL && !is_read && cmd != FLASH_CMD_PP) {
+        return FLASH_STATUS_ERROR;
+    }
+    if (data == NULL) {
+        len = 0;
+    }
+
+    // Only referenced until spi_queue_wait() returns
+    const spi_queue_device_t device = {
+        .cs_pin    = EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN,
+        .lsb_first = EXTERNAL_FLASH_SPI_LSBFIRST,
+        .mode      = EXTERNAL_FLASH_SPI_MODE,
+        .divisor   = is_read ? EXTERNAL_FLASH_SPI_READ_CLOCK_DIVISOR : EXTERNAL_FLASH_SPI_CLOCK_DIVISOR,
+    };
+    spi_status_t response = SPI_STATUS_SUCCESS;
+
+    /* Reads longer than a single transfer are split into several, each with the address of its first byte. */
+    do {
+        uint8_t  header[SPI_QUEUE_MAX_HEADER_LENGTH];
+        uint8_t  header_length = spi_flash_header(header, cmd, addr);
+        uint16_t this_length   = (len > FLASH_SPI_MAX_TRANSFER_LENGTH) ? FLASH_SPI_MAX_TRANSFER_LENGTH : len;
+
+        bool queued = is_read ? spi_queue_receive(&device, header, header_length, data, this_length, spi_flash_transaction_complete, &response) : spi_queue_transmit(&device, header, header_length, data, this_length, spi_flash_transaction_complete, &response);
+        if (!queued) {
+            dprint("Failed to queue SPI transaction! [spi flash transmit]\n");
+            return FLASH_STATUS_ERROR;
+        }
+        spi_queue_wait();
+
+        if (data != NULL) {
+            data += this_length;
+        }
+        addr += this_length;
+        len -= this_length;
+    } while ((!response) && (len > 0));
+
+    return response;
+}
+#else
+/* This function is used for read transfer, write transfer and erase transfer. */
+static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t *data, size_t len) {
+    flash_status_t response = FLASH_STATUS_SUCCESS;
+    uint8_t        buffer[EXTERNAL_FLASH_ADDRESS_SIZE + 2];
+    uint16_t       header_length = spi_flash_header(buffer, cmd, addr);
+    bool           is_read       = (cmd == FLASH_CMD_READ || cmd == FLASH_CMD_FASTREAD);
+
+    bool res = spi_flash_start_with_divisor(is_read ? EXTERNAL_FLASH_SPI_READ_CLOCK_DIVISOR : EXTERNAL_FLASH_SPI_CLOCK_DIVISOR);
     if (!res) {
         dprint("Failed to start SPI! [spi flash transmit]\n");
         return FLASH_STATUS_ERROR;
     }
 
-    response = spi_transmit(buffer, sizeof(buffer));
+    response = spi_transmit(buffer, header_length);
 
     if ((!response) && (data != NULL)) {
-        switch (cmd) {
-            case FLASH_CMD_READ:
-                response = spi_receive(data, len);
-                break;
-            case FLASH_CMD_PP:
-                response = spi_transmit(data, len);
-                break;
-            default:
-                response = FLASH_STATUS_ERROR;
-                break;
+        if (is_read) {
+            /* The FLASH auto-increments the address, so large reads are streamed in as few bus transfers as possible. */
+            while ((!response) && (len > 0)) {
+                uint16_t this_length = (len > FLASH_SPI_MAX_TRANSFER_LENGTH) ? FLASH_SPI_MAX_TRANSFER_LENGTH : len;
+                response             = spi_receive(data, this_length);
+                data += this_length;
+                len -= this_length;
+            }
+        } else if (cmd == FLASH_CMD_PP) {
+            response = spi_transmit(data, len);
+        } else {
+            response = FLASH_STATUS_ERROR;
         }
     }
 
@@ -161,14 +242,19 @@ static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t
 
     return response;
 }
+#endif
 
 void flash_init(void) {
     spi_init();
 }
 
+__attribute__((weak)) void flash_contents_changing(void) {}
+
 flash_status_t flash_erase_chip(void) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
 
+    flash_contents_changing();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -211,6 +297,8 @@ flash_status_t flash_erase_sector(uint32_t addr) {
         return FLASH_STATUS_ERROR;
     }
 
+    flash_contents_changing();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -251,6 +339,8 @@ flash_status_t flash_erase_block(uint32_t addr) {
         return FLASH_STATUS_ERROR;
     }
 
+    flash_contents_changing();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -295,7 +385,7 @@ flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
     }
 
     /* Perform read. */
-    response = spi_flash_transaction(FLASH_CMD_READ, addr, read_buf, len);
+    response = spi_flash_transaction(FLASH_CMD_READ_DATA, addr, read_buf, len);
     if (response != FLASH_STATUS_SUCCESS) {
         dprint("Failed to read block! [spi flash read block]\n");
         memset(read_buf, 0, len);
@@ -317,6 +407,8 @@ flash_status_t flash_write_block(uint32_t addr, const void *buf, size_t len) {
     flash_status_t response  = FLASH_STATUS_SUCCESS;
     uint8_t *      write_buf = (uint8_t *)buf;
 
+    flash_contents_changing();
+
     while (len > 0) {
         uint32_t page_offset  = addr % EXTERNAL_FLASH_PAGE_SIZE;
         size_t   write_length = EXTERNAL_FLASH_PAGE_SIZE - page_offset;
@@ -41,6 +41,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    endif
 #endif
 
+/*
+    The clock divisor used for read transactions. Most NOR FLASH chips can only
+    be clocked at their maximum frequency when using the FAST_READ command, so
+    this should only be set lower than EXTERNAL_FLASH_SPI_CLOCK_DIVISOR when
+    EXTERNAL_FLASH_SPI_FAST_READ is also defined.
+*/
+#ifndef EXTERNAL_FLASH_SPI_READ_CLOCK_DIVISOR
+#    define EXTERNAL_FLASH_SPI_READ_CLOCK_DIVISOR EXTERNAL_FLASH_SPI_CLOCK_DIVISOR
+#endif
+
+/*
+    Define EXTERNAL_FLASH_SPI_FAST_READ to issue the FAST_READ command instead
+    of READ for all reads. FAST_READ adds a dummy byte after the address, which
+    gives the FLASH enough time to be clocked at its maximum frequency.
+*/
+// #define EXTERNAL_FLASH_SPI_FAST_READ
+
 /*
     The SPI mode to communicate with the FLASH.
 */
@@ -131,6 +148,12 @@ flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len);
 
 flash_status_t flash_write_block(uint32_t addr, const void *buf, size_t len);
 
+/*
+    Invoked before the FLASH is erased or written, so that anything caching its
+    contents can discard them. Quantum Painter's flash streams override this.
+*/
+void flash_contents_changing(void);
+
 #ifdef __cplusplus
 }
 #endif
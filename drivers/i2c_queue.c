@@ -0,0 +1,113 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "i2c_queue.h"
+#include "bus_queue.h"
+
+static i2c_queue_job_t jobs[I2C_QUEUE_SIZE + 1];
+static bus_queue_t     queue = BUS_QUEUE_INIT(jobs);
+
+__attribute__((weak)) void i2c_queue_backend_kick(void) {
+    i2c_queue_process();
+}
+
+__attribute__((weak)) void i2c_queue_backend_wait(void) {
+    i2c_queue_process();
+}
+
+__attribute__((weak)) void i2c_queue_backend_complete(void) {}
+
+__attribute__((weak)) i2c_status_t i2c_queue_backend_transmit(uint8_t address, const uint8_t *data, uint16_t length) {
+    return i2c_transmit(address, data, length, I2C_QUEUE_TIMEOUT);
+}
+
+static bool i2c_queue_submit(const i2c_queue_job_t *job) {
+    if (job->length > I2C_QUEUE_MAX_LENGTH) {
+        return false;
+    }
+
+    while (bus_queue_is_full(&queue)) {
+        i2c_queue_task();
+        if (bus_queue_is_full(&queue)) {
+            i2c_queue_backend_wait();
+        }
+    }
+
+    *(i2c_queue_job_t *)bus_queue_reserve(&queue) = *job;
+    bus_queue_publish(&queue);
+
+    i2c_queue_backend_kick();
+    return true;
+}
+
+bool i2c_queue_write_register(uint8_t devaddr, uint8_t regaddr, uint8_t data, uint8_t attempts, i2c_queue_callback_t callback, void *context) {
+    i2c_queue_job_t job = {
+        .address  = devaddr,
+        .regaddr  = regaddr,
+        .value    = data,
+        .attempts = attempts,
+        .length   = 1,
+        .data     = NULL,
+        .callback = callback,
+        .context  = context,
+    };
+    return i2c_queue_submit(&job);
+}
+
+bool i2c_queue_write(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint8_t attempts, i2c_queue_callback_t callback, void *context) {
+    i2c_queue_job_t job = {
+        .address  = devaddr,
+        .regaddr  = regaddr,
+        .attempts = attempts,
+        .length   = length,
+        .data     = data,
+        .callback = callback,
+        .context  = context,
+    };
+    return i2c_queue_submit(&job);
+}
+
+void i2c_queue_process(void) {
+    static uint8_t packet[I2C_QUEUE_MAX_LENGTH + 1];
+
+    i2c_queue_job_t *job;
+    while ((job = bus_queue_next_pending(&queue))) {
+
+        packet[0] = job->regaddr;
+        if (job->data) {
+            memcpy(&packet[1], job->data, job->length);
+        } else {
+            packet[1] = job->value;
+        }
+
+        uint8_t attempts = job->attempts ? job->attempts : 1;
+        do {
+            job->status = i2c_queue_backend_transmit(job->address, packet, job->length + 1);
+        } while (job->status != I2C_STATUS_SUCCESS && --attempts);
+
+        bus_queue_finish(&queue);
+        i2c_queue_backend_complete();
+    }
+}
+
+void i2c_queue_task(void) {
+    i2c_queue_job_t *job;
+    while ((job = bus_queue_next_complete(&queue))) {
+        if (job->callback) {
+            job->callback(job->status, job->context);
+        }
+        bus_queue_release(&queue);
+    }
+}
+
+bool i2c_queue_is_idle(void) {
+    return bus_queue_is_empty(&queue);
+}
+
+void i2c_queue_wait(void) {
+    i2c_queue_task();
+    while (!i2c_queue_is_idle()) {
+        i2c_queue_backend_wait();
+        i2c_queue_task();
+    }
+}
@@ -0,0 +1,78 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_master.h"
+
+/*
+    Queue of I2C register writes which are carried out in the background.
+
+    Jobs are executed in the order they were submitted. Where the platform
+    supports it (ChibiOS), a worker thread performs the transfers so the caller
+    can return to scanning the matrix while the bus is busy; elsewhere jobs are
+    executed as soon as they are submitted.
+
+    The data passed to i2c_queue_write() is not copied, and must remain valid
+    until the job has completed. Reading it while it is being modified is
+    harmless for LED frame buffers, as the next flush sends the new values.
+*/
+
+/*
+    The number of jobs which can be pending at once. Submitting a job to a full
+    queue waits for the oldest job to complete.
+*/
+#ifndef I2C_QUEUE_SIZE
+#    define I2C_QUEUE_SIZE 16
+#endif
+
+/* The largest payload of a single job, excluding the register address */
+#ifndef I2C_QUEUE_MAX_LENGTH
+#    define I2C_QUEUE_MAX_LENGTH 64
+#endif
+
+/* Timeout in milliseconds for each attempt at a transfer */
+#ifndef I2C_QUEUE_TIMEOUT
+#    define I2C_QUEUE_TIMEOUT 100
+#endif
+
+/* Invoked from i2c_queue_task() once a job has completed */
+typedef void (*i2c_queue_callback_t)(i2c_status_t status, void *context);
+
+typedef struct i2c_queue_job_t {
+    uint8_t              address;
+    uint8_t              regaddr;
+    uint8_t              value;    // payload when data is NULL
+    uint8_t              attempts; // transfer is retried until it succeeds, at most this many times
+    uint16_t             length;
+    const uint8_t       *data;
+    i2c_queue_callback_t callback;
+    void                *context;
+    i2c_status_t         status;
+} i2c_queue_job_t;
+
+/* Queue a write of a single byte to regaddr. An attempts count of 0 is treated as 1. */
+bool i2c_queue_write_register(uint8_t devaddr, uint8_t regaddr, uint8_t data, uint8_t attempts, i2c_queue_callback_t callback, void *context);
+
+/* Queue a write of length bytes starting at regaddr */
+bool i2c_queue_write(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint8_t attempts, i2c_queue_callback_t callback, void *context);
+
+/* Invoke the callbacks of any completed jobs, and release their slots */
+void i2c_queue_task(void);
+
+/* Returns true when no jobs are pending, and all callbacks have been invoked */
+bool i2c_queue_is_idle(void);
+
+/* Block until all submitted jobs have completed */
+void i2c_queue_wait(void);
+
+/* Execute all jobs that have not been started yet -- invoked by the backend */
+void i2c_queue_process(void);
+
+// Backend hooks, overridden by platforms which can transfer in the background.
+// The defaults execute jobs synchronously as soon as they are submitted.
+void         i2c_queue_backend_kick(void);
+void         i2c_queue_backend_wait(void);
+void         i2c_queue_backend_complete(void); // invoked by i2c_queue_process() after each job
+i2c_status_t i2c_queue_backend_transmit(uint8_t address, const uint8_t *data, uint16_t length);
@@ -16,8 +16,12 @@
  */
 
 #include "aw20216s.h"
+#include <string.h>
 #include "wait.h"
 #include "spi_master.h"
+#ifdef SPI_QUEUE_ENABLE
+#    include "spi_queue.h"
+#endif
 
 #define AW20216S_PWM_REGISTER_COUNT 216
 
@@ -51,6 +55,10 @@ bool    g_pwm_buffer_update_required[AW20216S_DRIVER_COUNT] = {false};
 bool aw20216s_write(pin_t cs_pin, uint8_t page, uint8_t reg, uint8_t* data, uint8_t len) {
     static uint8_t s_spi_transfer_buffer[2] = {0};
 
+#ifdef SPI_QUEUE_ENABLE
+    // Let any queued writes complete first, so this one is not overtaken
+    spi_queue_wait();
+#endif
     if (!spi_start(cs_pin, false, AW20216S_SPI_MODE, AW20216S_SPI_DIVISOR)) {
         spi_stop();
         return false;
@@ -146,11 +154,45 @@ void aw20216s_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
     }
 }
 
+#ifdef SPI_QUEUE_ENABLE
+static spi_queue_device_t aw20216s_spi_devices[AW20216S_DRIVER_COUNT];
+static bool               aw20216s_pwm_write_pending[AW20216S_DRIVER_COUNT] = {false};
+// The frame being sent, so that g_pwm_buffer can keep changing while the transfer is in flight
+static uint8_t aw20216s_pwm_frame[AW20216S_DRIVER_COUNT][AW20216S_PWM_REGISTER_COUNT];
+
+static void aw20216s_write_pwm_complete(spi_status_t status, void *context) {
+    uint8_t index                     = (uint8_t)(uintptr_t)context;
+    aw20216s_pwm_write_pending[index] = false;
+    if (status != SPI_STATUS_SUCCESS) {
+        // Send the whole buffer again on the next flush
+        g_pwm_buffer_update_required[index] = true;
+    }
+}
+#endif
+
 void aw20216s_update_pwm_buffers(pin_t cs_pin, uint8_t index) {
+#ifdef SPI_QUEUE_ENABLE
+    // Queue a copy of the PWM registers. Only one frame per driver is in flight, changes made meanwhile are sent by the
+    // next flush after it completes.
+    if (g_pwm_buffer_update_required[index] && !aw20216s_pwm_write_pending[index]) {
+        spi_queue_device_t *device = &aw20216s_spi_devices[index];
+        device->cs_pin             = cs_pin;
+        device->lsb_first          = false;
+        device->mode               = AW20216S_SPI_MODE;
+        device->divisor            = AW20216S_SPI_DIVISOR;
+
+        memcpy(aw20216s_pwm_frame[index], g_pwm_buffer[index], AW20216S_PWM_REGISTER_COUNT);
+
+        uint8_t header[2]                   = {AW20216S_ID | AW20216S_PAGE_PWM | AW20216S_WRITE, 0};
+        g_pwm_buffer_update_required[index] = false;
+        aw20216s_pwm_write_pending[index]   = spi_queue_transmit(device, header, sizeof(header), aw20216s_pwm_frame[index], AW20216S_PWM_REGISTER_COUNT, aw20216s_write_pwm_complete, (void *)(uintptr_t)index);
+    }
+#else
     if (g_pwm_buffer_update_required[index]) {
         aw20216s_write(cs_pin, AW20216S_PAGE_PWM, 0, g_pwm_buffer[index], AW20216S_PWM_REGISTER_COUNT);
     }
     g_pwm_buffer_update_required[index] = false;
+#endif
 }
 
 void aw20216s_flush(void) {
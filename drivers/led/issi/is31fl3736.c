@@ -18,11 +18,19 @@
 #include "is31fl3736.h"
 #include <string.h>
 #include "i2c_master.h"
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
 #include "wait.h"
 
 #define IS31FL3736_PWM_REGISTER_COUNT 192 // actually 96
 #define IS31FL3736_LED_CONTROL_REGISTER_COUNT 24
 
+// The PWM registers are sent in windows of 16 bytes, tracked by one bit each
+#define IS31FL3736_PWM_WINDOW_SIZE 16
+#define IS31FL3736_PWM_WINDOW(reg) (1 << ((reg) / IS31FL3736_PWM_WINDOW_SIZE))
+#define IS31FL3736_PWM_WINDOW_ALL ((1 << (IS31FL3736_PWM_REGISTER_COUNT / IS31FL3736_PWM_WINDOW_SIZE)) - 1)
+
 #ifndef IS31FL3736_I2C_TIMEOUT
 #    define IS31FL3736_I2C_TIMEOUT 100
 #endif
@@ -56,13 +64,17 @@ uint8_t g_twi_transfer_buffer[20];
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3736_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[IS31FL3736_DRIVER_COUNT][IS31FL3736_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3736_DRIVER_COUNT] = {false};
+uint8_t  g_pwm_buffer[IS31FL3736_DRIVER_COUNT][IS31FL3736_PWM_REGISTER_COUNT];
+uint16_t g_pwm_buffer_update_required[IS31FL3736_DRIVER_COUNT] = {0}; // windows changed since the last flush
 
 uint8_t g_led_control_registers[IS31FL3736_DRIVER_COUNT][IS31FL3736_LED_CONTROL_REGISTER_COUNT] = {0};
 bool    g_led_control_registers_update_required[IS31FL3736_DRIVER_COUNT]                        = {false};
 
 void is31fl3736_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
+#ifdef I2C_QUEUE_ENABLE
+    // Let any queued writes complete first, so this one is not overtaken
+    i2c_queue_wait();
+#endif
     g_twi_transfer_buffer[0] = reg;
     g_twi_transfer_buffer[1] = data;
 
@@ -75,7 +87,40 @@ void is31fl3736_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+// Register writes made while flushing, which are queued to run in the background when possible
+static void is31fl3736_write_flush_register(uint8_t addr, uint8_t reg, uint8_t data) {
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_write_register(addr << 1, reg, data, IS31FL3736_I2C_PERSISTENCE, NULL, NULL);
+#else
+    is31fl3736_write_register(addr, reg, data);
+#endif
+}
+
+#ifdef I2C_QUEUE_ENABLE
+static void is31fl3736_write_pwm_complete(i2c_status_t status, void *context) {
+    if (status != I2C_STATUS_SUCCESS) {
+        // Send the window again on the next flush, and refresh page 0 in case it was dirtied
+        uint16_t offset = (uint8_t *)context - g_pwm_buffer[0];
+        uint8_t  index  = offset / IS31FL3736_PWM_REGISTER_COUNT;
+
+        g_led_control_registers_update_required[index] = true;
+
+        g_pwm_buffer_update_required[index] |= IS31FL3736_PWM_WINDOW(offset % IS31FL3736_PWM_REGISTER_COUNT);
+    }
+}
+#endif
+
+// Send the 16 byte windows of pwm_buffer selected by windows
+static void is31fl3736_write_pwm_windows(uint8_t addr, uint8_t *pwm_buffer, uint16_t windows) {
+#ifdef I2C_QUEUE_ENABLE
+    // Queue the PWM registers in 12 transfers of 16 bytes, sent straight from pwm_buffer.
+    for (int i = 0; i < IS31FL3736_PWM_REGISTER_COUNT; i += 16) {
+        if (!(windows & IS31FL3736_PWM_WINDOW(i))) {
+            continue;
+        }
+        i2c_queue_write(addr << 1, i, pwm_buffer + i, 16, IS31FL3736_I2C_PERSISTENCE, is31fl3736_write_pwm_complete, pwm_buffer + i);
+    }
+#else
     // assumes PG1 is already selected
 
     // transmit PWM registers in 12 transfers of 16 bytes
@@ -83,6 +128,9 @@ void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
 
     // iterate over the pwm_buffer contents at 16 byte intervals
     for (int i = 0; i < IS31FL3736_PWM_REGISTER_COUNT; i += 16) {
+        if (!(windows & IS31FL3736_PWM_WINDOW(i))) {
+            continue;
+        }
         g_twi_transfer_buffer[0] = i;
         // copy the data from i to i+15
         // device will auto-increment register for data after the first byte
@@ -97,6 +145,11 @@ void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
         i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, IS31FL3736_I2C_TIMEOUT);
 #endif
     }
+#endif
+}
+
+void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    is31fl3736_write_pwm_windows(addr, pwm_buffer, IS31FL3736_PWM_WINDOW_ALL);
 }
 
 void is31fl3736_init_drivers(void) {
@@ -182,10 +235,11 @@ void is31fl3736_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         if (g_pwm_buffer[led.driver][led.r] == red && g_pwm_buffer[led.driver][led.g] == green && g_pwm_buffer[led.driver][led.b] == blue) {
             return;
         }
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        g_pwm_buffer[led.driver][led.r] = red;
+        g_pwm_buffer[led.driver][led.g] = green;
+        g_pwm_buffer[led.driver][led.b] = blue;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3736_PWM_WINDOW(led.r) | IS31FL3736_PWM_WINDOW(led.g) | IS31FL3736_PWM_WINDOW(led.b);
     }
 }
 
@@ -235,11 +289,11 @@ void is31fl3736_set_led_control_register(uint8_t index, bool red, bool green, bo
 void is31fl3736_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
         // Firstly we need to unlock the command register and select PG1
-        is31fl3736_write_register(addr, IS31FL3736_REG_COMMAND_WRITE_LOCK, IS31FL3736_COMMAND_WRITE_LOCK_MAGIC);
-        is31fl3736_write_register(addr, IS31FL3736_REG_COMMAND, IS31FL3736_COMMAND_PWM);
+        is31fl3736_write_flush_register(addr, IS31FL3736_REG_COMMAND_WRITE_LOCK, IS31FL3736_COMMAND_WRITE_LOCK_MAGIC);
+        is31fl3736_write_flush_register(addr, IS31FL3736_REG_COMMAND, IS31FL3736_COMMAND_PWM);
 
-        is31fl3736_write_pwm_buffer(addr, g_pwm_buffer[index]);
-        g_pwm_buffer_update_required[index] = false;
+        is31fl3736_write_pwm_windows(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
+        g_pwm_buffer_update_required[index] = 0;
     }
 }
 
@@ -20,10 +20,18 @@
 #include "is31fl3741-simple.h"
 #include <string.h>
 #include "i2c_master.h"
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
 #include "wait.h"
 
 #define IS31FL3741_PWM_REGISTER_COUNT 351
 
+// The PWM registers are sent in windows of 18 bytes, tracked by one bit each
+#define IS31FL3741_PWM_WINDOW_SIZE 18
+#define IS31FL3741_PWM_WINDOW(reg) (1UL << ((reg) / IS31FL3741_PWM_WINDOW_SIZE))
+#define IS31FL3741_PWM_WINDOW_ALL ((1UL << ((IS31FL3741_PWM_REGISTER_COUNT + IS31FL3741_PWM_WINDOW_SIZE - 1) / IS31FL3741_PWM_WINDOW_SIZE)) - 1)
+
 #ifndef IS31FL3741_I2C_TIMEOUT
 #    define IS31FL3741_I2C_TIMEOUT 100
 #endif
@@ -61,13 +69,17 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3741_DRIVER_COUNT]        = {false};
-bool    g_scaling_registers_update_required[IS31FL3741_DRIVER_COUNT] = {false};
+uint8_t  g_pwm_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
+uint32_t g_pwm_buffer_update_required[IS31FL3741_DRIVER_COUNT]        = {0}; // windows changed since the last flush
+bool     g_scaling_registers_update_required[IS31FL3741_DRIVER_COUNT] = {false};
 
 uint8_t g_scaling_registers[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
 
 void is31fl3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
+#ifdef I2C_QUEUE_ENABLE
+    // Let any queued writes complete first, so this one is not overtaken
+    i2c_queue_wait();
+#endif
     g_twi_transfer_buffer[0] = reg;
     g_twi_transfer_buffer[1] = data;
 
@@ -80,51 +92,74 @@ void is31fl3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-bool is31fl3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+// Register writes made while flushing, which are queued to run in the background when possible
+static void is31fl3741_write_flush_register(uint8_t addr, uint8_t reg, uint8_t data) {
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_write_register(addr << 1, reg, data, IS31FL3741_I2C_PERSISTENCE, NULL, NULL);
+#else
+    is31fl3741_write_register(addr, reg, data);
+#endif
+}
+
+#ifdef I2C_QUEUE_ENABLE
+static void is31fl3741_write_pwm_complete(i2c_status_t status, void *context) {
+    if (status != I2C_STATUS_SUCCESS) {
+        // Send the window again on the next flush, which selects its page again
+        uint16_t offset = (uint8_t *)context - g_pwm_buffer[0];
+        uint8_t  index  = offset / IS31FL3741_PWM_REGISTER_COUNT;
+
+        g_pwm_buffer_update_required[index] |= IS31FL3741_PWM_WINDOW(offset % IS31FL3741_PWM_REGISTER_COUNT);
+    }
+}
+#endif
+
+// Send the 18 byte windows of pwm_buffer selected by windows
+static bool is31fl3741_write_pwm_windows(uint8_t addr, uint8_t *pwm_buffer, uint32_t windows) {
     // Assume PG0 is already selected
+    bool is_page_1 = false;
 
-    for (int i = 0; i < 342; i += 18) {
-        if (i == 180) {
+    for (int i = 0; i < IS31FL3741_PWM_REGISTER_COUNT; i += 18) {
+        if (!(windows & IS31FL3741_PWM_WINDOW(i))) {
+            continue;
+        }
+
+        if (i >= 180 && !is_page_1) {
             // unlock the command register and select PG1
-            is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
-            is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_1);
+            is31fl3741_write_flush_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
+            is31fl3741_write_flush_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_1);
+            is_page_1 = true;
         }
 
+        // the last window is short, as the total number is 351
+        uint8_t length = IS31FL3741_PWM_REGISTER_COUNT - i < 18 ? IS31FL3741_PWM_REGISTER_COUNT - i : 18;
+
+#ifdef I2C_QUEUE_ENABLE
+        i2c_queue_write(addr << 1, i % 180, pwm_buffer + i, length, IS31FL3741_I2C_PERSISTENCE, is31fl3741_write_pwm_complete, pwm_buffer + i);
+#else
         g_twi_transfer_buffer[0] = i % 180;
-        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, 18);
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, length);
 
-#if IS31FL3741_I2C_PERSISTENCE > 0
+#    if IS31FL3741_I2C_PERSISTENCE > 0
         for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, IS31FL3741_I2C_TIMEOUT) != 0) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, IS31FL3741_I2C_TIMEOUT) != 0) {
                 return false;
             }
         }
-#else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, IS31FL3741_I2C_TIMEOUT) != 0) {
+#    else
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, IS31FL3741_I2C_TIMEOUT) != 0) {
             return false;
         }
+#    endif
 #endif
     }
 
-    // transfer the left cause the total number is 351
-    g_twi_transfer_buffer[0] = 162;
-    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + 342, 9);
-
-#if IS31FL3741_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, IS31FL3741_I2C_TIMEOUT) != 0) {
-            return false;
-        }
-    }
-#else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, IS31FL3741_I2C_TIMEOUT) != 0) {
-        return false;
-    }
-#endif
-
     return true;
 }
 
+bool is31fl3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    return is31fl3741_write_pwm_windows(addr, pwm_buffer, IS31FL3741_PWM_WINDOW_ALL);
+}
+
 void is31fl3741_init_drivers(void) {
     i2c_init();
 
@@ -192,8 +227,9 @@ void is31fl3741_set_value(int index, uint8_t value) {
         if (g_pwm_buffer[led.driver][led.v] == value) {
             return;
         }
-        g_pwm_buffer_update_required[led.driver] = true;
-        g_pwm_buffer[led.driver][led.v]          = value;
+        g_pwm_buffer[led.driver][led.v] = value;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3741_PWM_WINDOW(led.v);
     }
 }
 
@@ -219,19 +255,22 @@ void is31fl3741_set_led_control_register(uint8_t index, bool value) {
 void is31fl3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
         // unlock the command register and select PG2
-        is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
-        is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_0);
+        is31fl3741_write_flush_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
+        is31fl3741_write_flush_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_0);
 
-        is31fl3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        is31fl3741_write_pwm_windows(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
     }
 
-    g_pwm_buffer_update_required[index] = false;
+    g_pwm_buffer_update_required[index] = 0;
 }
 
 void is31fl3741_set_pwm_buffer(const is31fl3741_led_t *pled, uint8_t value) {
+    if (g_pwm_buffer[pled->driver][pled->v] == value) {
+        return;
+    }
     g_pwm_buffer[pled->driver][pled->v] = value;
 
-    g_pwm_buffer_update_required[pled->driver] = true;
+    g_pwm_buffer_update_required[pled->driver] |= IS31FL3741_PWM_WINDOW(pled->v);
 }
 
 void is31fl3741_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -31,13 +31,16 @@
 #    define ISSI_PERSISTENCE 0
 #endif
 
+// The PWM registers are sent in windows of ISSI_PWM_TRF_SIZE bytes, tracked by one bit each
+#define ISSI_PWM_WINDOW(reg) (1 << ((reg) / ISSI_PWM_TRF_SIZE))
+
 // Transfer buffer for TWITransmitData()
 uint8_t g_twi_transfer_buffer[20];
 
 // These buffers match the PWM & scaling registers.
 // Storing them like this is optimal for I2C transfers to the registers.
-uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+uint8_t  g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
+uint16_t g_pwm_buffer_update_required[DRIVER_COUNT] = {0}; // windows changed since the last flush
 
 uint8_t g_scaling_buffer[DRIVER_COUNT][ISSI_SCALING_SIZE];
 bool    g_scaling_buffer_update_required[DRIVER_COUNT] = {false};
@@ -124,10 +127,14 @@ void IS31FL_common_update_pwm_register(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
         // Queue up the correct page
         IS31FL_unlock_register(addr, ISSI_PAGE_PWM);
-        // Hand off the update to IS31FL_write_multi_registers
-        IS31FL_write_multi_registers(addr, g_pwm_buffer[index], ISSI_MAX_LEDS, ISSI_PWM_TRF_SIZE, ISSI_PWM_REG_1ST);
+        // Hand off each changed window to IS31FL_write_multi_registers
+        for (int i = 0; i < ISSI_MAX_LEDS; i += ISSI_PWM_TRF_SIZE) {
+            if (g_pwm_buffer_update_required[index] & ISSI_PWM_WINDOW(i)) {
+                IS31FL_write_multi_registers(addr, g_pwm_buffer[index] + i, ISSI_PWM_TRF_SIZE, ISSI_PWM_TRF_SIZE, ISSI_PWM_REG_1ST + i);
+            }
+        }
         // Update flags that pwm_buffer has been updated
-        g_pwm_buffer_update_required[index] = false;
+        g_pwm_buffer_update_required[index] = 0;
     }
 }
 
@@ -229,10 +236,14 @@ void IS31FL_RGB_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         is31_led led;
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        if (g_pwm_buffer[led.driver][led.r] == red && g_pwm_buffer[led.driver][led.g] == green && g_pwm_buffer[led.driver][led.b] == blue) {
+            return;
+        }
+        g_pwm_buffer[led.driver][led.r] = red;
+        g_pwm_buffer[led.driver][led.g] = green;
+        g_pwm_buffer[led.driver][led.b] = blue;
+
+        g_pwm_buffer_update_required[led.driver] |= ISSI_PWM_WINDOW(led.r) | ISSI_PWM_WINDOW(led.g) | ISSI_PWM_WINDOW(led.b);
     }
 }
 
@@ -317,8 +328,12 @@ void IS31FL_simple_set_brightness(int index, uint8_t value) {
         is31_led led;
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
+        if (g_pwm_buffer[led.driver][led.v] == value) {
+            return;
+        }
         g_pwm_buffer[led.driver][led.v] = value;
-        g_pwm_buffer_update_required[led.driver] = true;
+
+        g_pwm_buffer_update_required[led.driver] |= ISSI_PWM_WINDOW(led.v);
     }
 }
 
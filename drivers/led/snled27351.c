@@ -16,6 +16,9 @@
 
 #include "snled27351.h"
 #include "i2c_master.h"
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
 
 #define SNLED27351_PWM_REGISTER_COUNT 192
 #define SNLED27351_LED_CONTROL_REGISTER_COUNT 24
@@ -53,6 +56,10 @@ uint8_t g_led_control_registers[SNLED27351_DRIVER_COUNT][SNLED27351_LED_CONTROL_
 bool    g_led_control_registers_update_required[SNLED27351_DRIVER_COUNT]                        = {false};
 
 bool snled27351_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
+#ifdef I2C_QUEUE_ENABLE
+    // Let any queued writes complete first, so this one is not overtaken
+    i2c_queue_wait();
+#endif
     // If the transaction fails function returns false.
     g_twi_transfer_buffer[0] = reg;
     g_twi_transfer_buffer[1] = data;
@@ -71,7 +78,34 @@ bool snled27351_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     return true;
 }
 
+// Register writes made while flushing, which are queued to run in the background when possible
+static void snled27351_write_flush_register(uint8_t addr, uint8_t reg, uint8_t data) {
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_write_register(addr << 1, reg, data, SNLED27351_I2C_PERSISTENCE, NULL, NULL);
+#else
+    snled27351_write_register(addr, reg, data);
+#endif
+}
+
+#ifdef I2C_QUEUE_ENABLE
+static void snled27351_write_pwm_complete(i2c_status_t status, void *context) {
+    if (status != I2C_STATUS_SUCCESS) {
+        // Send the whole buffer again on the next flush, and refresh page 0 in case it was dirtied
+        uint8_t index                                  = ((uint8_t *)context - g_pwm_buffer[0]) / SNLED27351_PWM_REGISTER_COUNT;
+        g_pwm_buffer_update_required[index]            = true;
+        g_led_control_registers_update_required[index] = true;
+    }
+}
+#endif
+
 bool snled27351_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+#ifdef I2C_QUEUE_ENABLE
+    // Queue the PWM registers in 3 transfers of 64 bytes, sent straight from pwm_buffer.
+    for (int i = 0; i < SNLED27351_PWM_REGISTER_COUNT; i += 64) {
+        i2c_queue_write(addr << 1, i, pwm_buffer + i, 64, SNLED27351_I2C_PERSISTENCE, snled27351_write_pwm_complete, pwm_buffer);
+    }
+    return true;
+#else
     // Assumes PG1 is already selected.
     // If any of the transactions fails function returns false.
     // Transmit PWM registers in 3 transfers of 64 bytes.
@@ -99,6 +133,7 @@ bool snled27351_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
 #endif
     }
     return true;
+#endif
 }
 
 void snled27351_init_drivers(void) {
@@ -230,7 +265,7 @@ void snled27351_set_led_control_register(uint8_t index, bool red, bool green, bo
 
 void snled27351_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
-        snled27351_write_register(addr, SNLED27351_REG_COMMAND, SNLED27351_COMMAND_PWM);
+        snled27351_write_flush_register(addr, SNLED27351_REG_COMMAND, SNLED27351_COMMAND_PWM);
 
         // If any of the transactions fail we risk writing dirty PG0,
         // refresh page 0 just in case.
@@ -172,7 +172,7 @@ typedef struct {
 #ifndef AZOTEQ_IQS5XX_REPORT_RATE
 #    define AZOTEQ_IQS5XX_REPORT_RATE 10
 #endif
-#if !defined(POINTING_DEVICE_TASK_THROTTLE_MS) && !defined(POINTING_DEVICE_MOTION_PIN)
+#if !defined(POINTING_DEVICE_TASK_THROTTLE_MS) && !defined(POINTING_DEVICE_MOTION_PIN) && !defined(POINTING_DEVICE_SENSOR_COUNT)
 #    define POINTING_DEVICE_TASK_THROTTLE_MS AZOTEQ_IQS5XX_REPORT_RATE
 #endif
 
@@ -191,3 +191,16 @@ void           azoteq_iqs5xx_set_cpi(uint16_t cpi);
 uint16_t       azoteq_iqs5xx_get_cpi(void);
 uint16_t       azoteq_iqs5xx_get_product(void);
 void           azoteq_iqs5xx_setup_resolution(void);
+
+#ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+/* Implementation in pointing_device_drivers.c */
+
+/* Enable/disable inertial cursor */
+void azoteq_iqs5xx_enable_cursor_glide(bool enable);
+
+/*
+ * Configure inertial cursor.
+ * @param trigger_px Movement required to trigger cursor glide.
+ */
+void azoteq_iqs5xx_configure_cursor_glide(uint16_t trigger_px);
+#endif
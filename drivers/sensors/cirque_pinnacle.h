@@ -52,7 +52,8 @@
 #        define CIRQUE_PINNACLE_SIDE_SCROLL_ENABLE
 #    endif
 #endif
-#if !defined(POINTING_DEVICE_TASK_THROTTLE_MS)
+// With a sensor table, the Cirque's own interval is set in its entry instead, so other sensors are not slowed down
+#if !defined(POINTING_DEVICE_TASK_THROTTLE_MS) && !defined(POINTING_DEVICE_SENSOR_COUNT)
 #    define POINTING_DEVICE_TASK_THROTTLE_MS 10 // Cirque Pinnacle in normal operation produces data every 10ms. Advanced configuration for pen/stylus usage might require lower values.
 #endif
 #if defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c)
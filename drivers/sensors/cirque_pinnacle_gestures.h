@@ -17,6 +17,7 @@
 #pragma once
 
 #include "cirque_pinnacle.h"
+#include "pointing_device_gestures.h"
 #include "report.h"
 
 typedef struct {
@@ -34,11 +35,6 @@ typedef struct {
 #        define CIRQUE_PINNACLE_TOUCH_DEBOUNCE (CIRQUE_PINNACLE_TAPPING_TERM * 8)
 #    endif
 
-typedef struct {
-    uint16_t timer;
-    bool     touchDown;
-} trackpad_tap_context_t;
-
 /* Enable/disable tap gesture */
 void cirque_pinnacle_enable_tap(bool enable);
 #endif
@@ -47,37 +43,6 @@ void cirque_pinnacle_enable_tap(bool enable);
 #    if !CIRQUE_PINNACLE_POSITION_MODE
 #        error "Circular scroll is not supported in relative mode"
 #    endif
-typedef enum {
-    SCROLL_UNINITIALIZED,
-    SCROLL_DETECTING,
-    SCROLL_VALID,
-    NOT_SCROLL,
-} circular_scroll_status_t;
-
-typedef struct {
-    int8_t v;
-    int8_t h;
-    bool   suppress_touch;
-} circular_scroll_t;
-
-typedef struct {
-    uint8_t  outer_ring_pct; /* Width of outer ring, given as a percentage of the radius */
-    uint8_t  trigger_px;     /* Amount of movement before triggering scroll validation, in pixels 0~127 */
-    uint16_t trigger_ang;    /* Angle required to validate scroll, in radians where pi = 32768 */
-    uint8_t  wheel_clicks;   /* How many clicks to report in a circle */
-    bool     left_handed;    /* Whether scrolling should be flipped for left handed use */
-} circular_scroll_config_t;
-
-typedef struct {
-    circular_scroll_config_t config;
-    circular_scroll_status_t state;
-    uint8_t                  mag;
-    int8_t                   x;
-    int8_t                   y;
-    uint16_t                 z;
-    bool                     axis;
-} circular_scroll_context_t;
-
 /* Enable/disable circular scroll gesture */
 void cirque_pinnacle_enable_circular_scroll(bool enable);
 
@@ -103,7 +68,7 @@ void cirque_pinnacle_enable_cursor_glide(bool enable);
  * Configure inertial cursor.
  * @param trigger_px Movement required to trigger cursor glide, set this to non-zero if you have some amount of hover.
  */
-void cirque_pinnacle_configure_cursor_glide(float trigger_px);
+void cirque_pinnacle_configure_cursor_glide(uint16_t trigger_px);
 #endif
 
 /* Process available gestures */
@@ -0,0 +1,123 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "spi_queue.h"
+#include "bus_queue.h"
+
+static spi_queue_job_t jobs[SPI_QUEUE_SIZE + 1];
+static bus_queue_t     queue = BUS_QUEUE_INIT(jobs);
+
+__attribute__((weak)) void spi_queue_backend_kick(void) {
+    spi_queue_process();
+}
+
+__attribute__((weak)) void spi_queue_backend_wait(void) {
+    spi_queue_process();
+}
+
+__attribute__((weak)) void spi_queue_backend_complete(void) {}
+
+__attribute__((weak)) bool spi_queue_backend_start(const spi_queue_device_t *device) {
+    return spi_start(device->cs_pin, device->lsb_first, device->mode, device->divisor);
+}
+
+__attribute__((weak)) spi_status_t spi_queue_backend_transmit(const uint8_t *data, uint16_t length) {
+    return spi_transmit(data, length);
+}
+
+__attribute__((weak)) spi_status_t spi_queue_backend_receive(uint8_t *data, uint16_t length) {
+    return spi_receive(data, length);
+}
+
+__attribute__((weak)) void spi_queue_backend_stop(void) {
+    spi_stop();
+}
+
+static bool spi_queue_submit(const spi_queue_device_t *device, const uint8_t *header, uint8_t header_length, const uint8_t *tx, uint8_t *rx, uint16_t length, spi_queue_callback_t callback, void *context) {
+    if (header_length > SPI_QUEUE_MAX_HEADER_LENGTH) {
+        return false;
+    }
+
+    while (bus_queue_is_full(&queue)) {
+        spi_queue_task();
+        if (bus_queue_is_full(&queue)) {
+            spi_queue_backend_wait();
+        }
+    }
+
+    spi_queue_job_t *job = bus_queue_reserve(&queue);
+    job->device          = device;
+    job->header_length   = header_length;
+    if (header_length) {
+        memcpy(job->header, header, header_length);
+    }
+    job->tx       = tx;
+    job->rx       = rx;
+    job->length   = length;
+    job->callback = callback;
+    job->context  = context;
+    bus_queue_publish(&queue);
+
+    spi_queue_backend_kick();
+    return true;
+}
+
+bool spi_queue_transmit(const spi_queue_device_t *device, const uint8_t *header, uint8_t header_length, const uint8_t *data, uint16_t length, spi_queue_callback_t callback, void *context) {
+    return spi_queue_submit(device, header, header_length, data, NULL, length, callback, context);
+}
+
+bool spi_queue_receive(const spi_queue_device_t *device, const uint8_t *header, uint8_t header_length, uint8_t *data, uint16_t length, spi_queue_callback_t callback, void *context) {
+    return spi_queue_submit(device, header, header_length, NULL, data, length, callback, context);
+}
+
+static spi_status_t spi_queue_execute(spi_queue_job_t *job) {
+    if (!spi_queue_backend_start(job->device)) {
+        return SPI_STATUS_ERROR;
+    }
+
+    spi_status_t status = SPI_STATUS_SUCCESS;
+    if (job->header_length) {
+        status = spi_queue_backend_transmit(job->header, job->header_length);
+    }
+    if (status == SPI_STATUS_SUCCESS && job->length) {
+        if (job->rx) {
+            status = spi_queue_backend_receive(job->rx, job->length);
+        } else {
+            status = spi_queue_backend_transmit(job->tx, job->length);
+        }
+    }
+
+    spi_queue_backend_stop();
+    return status;
+}
+
+void spi_queue_process(void) {
+    spi_queue_job_t *job;
+    while ((job = bus_queue_next_pending(&queue))) {
+        job->status = spi_queue_execute(job);
+        bus_queue_finish(&queue);
+        spi_queue_backend_complete();
+    }
+}
+
+void spi_queue_task(void) {
+    spi_queue_job_t *job;
+    while ((job = bus_queue_next_complete(&queue))) {
+        if (job->callback) {
+            job->callback(job->status, job->context);
+        }
+        bus_queue_release(&queue);
+    }
+}
+
+bool spi_queue_is_idle(void) {
+    return bus_queue_is_empty(&queue);
+}
+
+void spi_queue_wait(void) {
+    spi_queue_task();
+    while (!spi_queue_is_idle()) {
+        spi_queue_backend_wait();
+        spi_queue_task();
+    }
+}
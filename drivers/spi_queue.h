@@ -0,0 +1,87 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spi_master.h"
+
+/*
+    Queue of SPI transactions which are carried out in the background.
+
+    Each transaction selects its device, sends a short header such as a
+    command and address, then sends or receives a block of data, and
+    deselects the device again. Transactions for all devices on the bus are
+    executed in the order they were submitted. Where the platform supports it
+    (ChibiOS), a worker thread performs the transfers so the caller can return
+    to scanning the matrix while the bus is busy; elsewhere transactions are
+    executed as soon as they are submitted.
+
+    The header is copied, the data is not: data passed to spi_queue_transmit()
+    must remain valid, and the buffer passed to spi_queue_receive() must not be
+    used, until the transaction has completed.
+*/
+
+/*
+    The number of transactions which can be pending at once. Submitting a
+    transaction to a full queue waits for the oldest one to complete.
+*/
+#ifndef SPI_QUEUE_SIZE
+#    define SPI_QUEUE_SIZE 16
+#endif
+
+/* The longest header of a single transaction, enough for a flash command, 4 byte address and dummy byte */
+#ifndef SPI_QUEUE_MAX_HEADER_LENGTH
+#    define SPI_QUEUE_MAX_HEADER_LENGTH 6
+#endif
+
+/* The bus settings of a device, which must remain valid while it has transactions queued */
+typedef struct spi_queue_device_t {
+    pin_t    cs_pin;
+    bool     lsb_first;
+    uint8_t  mode;
+    uint16_t divisor;
+} spi_queue_device_t;
+
+/* Invoked from spi_queue_task() once a transaction has completed */
+typedef void (*spi_queue_callback_t)(spi_status_t status, void *context);
+
+typedef struct spi_queue_job_t {
+    const spi_queue_device_t *device;
+    uint8_t                   header[SPI_QUEUE_MAX_HEADER_LENGTH];
+    uint8_t                   header_length;
+    const uint8_t            *tx; // data sent after the header, when rx is NULL
+    uint8_t                  *rx; // buffer for data received after the header
+    uint16_t                  length;
+    spi_queue_callback_t      callback;
+    void                     *context;
+    spi_status_t              status;
+} spi_queue_job_t;
+
+/* Queue a transaction sending header, then length bytes of data */
+bool spi_queue_transmit(const spi_queue_device_t *device, const uint8_t *header, uint8_t header_length, const uint8_t *data, uint16_t length, spi_queue_callback_t callback, void *context);
+
+/* Queue a transaction sending header, then receiving length bytes into data */
+bool spi_queue_receive(const spi_queue_device_t *device, const uint8_t *header, uint8_t header_length, uint8_t *data, uint16_t length, spi_queue_callback_t callback, void *context);
+
+/* Invoke the callbacks of any completed transactions, and release their slots */
+void spi_queue_task(void);
+
+/* Returns true when no transactions are pending, and all callbacks have been invoked */
+bool spi_queue_is_idle(void);
+
+/* Block until all submitted transactions have completed */
+void spi_queue_wait(void);
+
+/* Execute all transactions that have not been started yet -- invoked by the backend */
+void spi_queue_process(void);
+
+// Backend hooks, overridden by platforms which can transfer in the background.
+// The defaults execute transactions synchronously as soon as they are submitted.
+void         spi_queue_backend_kick(void);
+void         spi_queue_backend_wait(void);
+void         spi_queue_backend_complete(void); // invoked by spi_queue_process() after each transaction
+bool         spi_queue_backend_start(const spi_queue_device_t *device);
+spi_status_t spi_queue_backend_transmit(const uint8_t *data, uint16_t length);
+spi_status_t spi_queue_backend_receive(uint8_t *data, uint16_t length);
+void         spi_queue_backend_stop(void);
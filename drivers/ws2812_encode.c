@@ -0,0 +1,64 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "ws2812_encode.h"
+
+#define SPI_SYMBOL(data, bit) (((data) >> (bit)) & 1 ? 0b1110 : 0b1000)
+#define SPI_PAIR(data, bit) ((SPI_SYMBOL(data, bit) << 4) | SPI_SYMBOL(data, (bit)-1))
+#define SPI_BYTE(data) {SPI_PAIR(data, 7), SPI_PAIR(data, 5), SPI_PAIR(data, 3), SPI_PAIR(data, 1)}
+#define SPI_BYTE_4(data) SPI_BYTE(data), SPI_BYTE((data) + 1), SPI_BYTE((data) + 2), SPI_BYTE((data) + 3)
+#define SPI_BYTE_16(data) SPI_BYTE_4(data), SPI_BYTE_4((data) + 4), SPI_BYTE_4((data) + 8), SPI_BYTE_4((data) + 12)
+#define SPI_BYTE_64(data) SPI_BYTE_16(data), SPI_BYTE_16((data) + 16), SPI_BYTE_16((data) + 32), SPI_BYTE_16((data) + 48)
+
+static const uint8_t spi_lut[256][WS2812_SPI_BYTES_PER_CHANNEL] = {SPI_BYTE_64(0), SPI_BYTE_64(64), SPI_BYTE_64(128), SPI_BYTE_64(192)};
+
+#ifdef WS2812_ENCODE_INCREMENTAL
+static rgb_led_t last_encoded[WS2812_LED_COUNT];
+static bool      last_encoded_valid[WS2812_LED_COUNT];
+#endif
+
+void ws2812_encode_channels(const rgb_led_t *led, uint8_t channels[WS2812_CHANNELS]) {
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+    channels[0] = led->g;
+    channels[1] = led->r;
+    channels[2] = led->b;
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+    channels[0] = led->r;
+    channels[1] = led->g;
+    channels[2] = led->b;
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+    channels[0] = led->b;
+    channels[1] = led->g;
+    channels[2] = led->r;
+#endif
+#ifdef RGBW
+    channels[3] = led->w;
+#endif
+}
+
+bool ws2812_encode_led_changed(uint16_t index, const rgb_led_t *led, uint8_t channels[WS2812_CHANNELS]) {
+#ifdef WS2812_ENCODE_INCREMENTAL
+    if (index < WS2812_LED_COUNT) {
+        if (last_encoded_valid[index] && memcmp(&last_encoded[index], led, sizeof(rgb_led_t)) == 0) {
+            return false;
+        }
+        last_encoded[index]       = *led;
+        last_encoded_valid[index] = true;
+    }
+#endif
+    ws2812_encode_channels(led, channels);
+    return true;
+}
+
+void ws2812_encode_invalidate(void) {
+#ifdef WS2812_ENCODE_INCREMENTAL
+    memset(last_encoded_valid, 0, sizeof(last_encoded_valid));
+#endif
+}
+
+void ws2812_encode_spi(const uint8_t *channels, uint8_t count, uint8_t *out) {
+    for (uint8_t i = 0; i < count; i++) {
+        memcpy(out, spi_lut[channels[i]], WS2812_SPI_BYTES_PER_CHANNEL);
+        out += WS2812_SPI_BYTES_PER_CHANNEL;
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ws2812.h"
+
+/*
+    Shared colour encoding for the WS2812 drivers.
+
+    Colours are converted to the bytes sent over the wire (in WS2812_BYTE_ORDER)
+    once, here, rather than by each driver.
+    Drivers with a persistent frame buffer can use ws2812_encode_led_changed()
+    to skip re-encoding LEDs whose colour is the same as the previous flush.
+*/
+
+#ifdef RGBW
+#    define WS2812_CHANNELS 4
+#else
+#    define WS2812_CHANNELS 3
+#endif
+
+/* Number of SPI bytes used to encode a single colour byte, see ws2812_encode_spi() */
+#define WS2812_SPI_BYTES_PER_CHANNEL 4
+
+#if defined(WS2812_LED_COUNT) && !defined(WS2812_ENCODE_NO_INCREMENTAL)
+#    define WS2812_ENCODE_INCREMENTAL
+#endif
+
+/* Convert a colour into the bytes sent over the wire */
+void ws2812_encode_channels(const rgb_led_t *led, uint8_t channels[WS2812_CHANNELS]);
+
+/*
+    As ws2812_encode_channels(), but returns false without touching channels if
+    the LED at index was encoded with the same colour last time. Always returns
+    true if incremental encoding is disabled.
+*/
+bool ws2812_encode_led_changed(uint16_t index, const rgb_led_t *led, uint8_t channels[WS2812_CHANNELS]);
+
+/* Force every LED to be re-encoded on the next flush */
+void ws2812_encode_invalidate(void);
+
+/*
+    Convert wire bytes into the waveform used by the SPI driver: each colour bit
+    becomes a 4-bit symbol, 0b1000 for a 0 and 0b1110 for a 1, most significant
+    bit first. Writes count * WS2812_SPI_BYTES_PER_CHANNEL bytes to out.
+*/
+void ws2812_encode_spi(const uint8_t *channels, uint8_t count, uint8_t *out);
@@ -145,10 +145,23 @@ extern uint8_t note_timbre;
 #endif
 // -----------------------------------------------------------------------------
 
+// Timer counts per period of a tone with the given frequency. The frequency is reduced to Q24.8 so that the division
+// fits in 32 bits, which is plenty for the 16 bit timer registers.
+_Static_assert((F_CPU / CPU_PRESCALER) < ((uint32_t)1 << 24), "F_CPU / CPU_PRESCALER must fit in 24 bits");
+static uint16_t pwm_period(audio_freq_q16_t freq) {
+    uint32_t freq_q8 = freq >> 8;
+    if (freq_q8 == 0) {
+        freq_q8 = 1;
+    }
+    uint32_t period = ((uint32_t)(F_CPU / CPU_PRESCALER) << 8) / freq_q8;
+    return period > UINT16_MAX ? UINT16_MAX : period;
+}
+
 #ifdef AUDIO1_PIN_SET
-static float channel_1_frequency = 0.0f;
-void         channel_1_set_frequency(float freq) {
-    if (freq == 0.0f) // a pause/rest is a valid "note" with freq=0
+// number of timer ISR calls between audio state updates, which depends on the frequency being played
+static uint16_t channel_1_update_interval = 0;
+void            channel_1_set_frequency(audio_freq_q16_t freq) {
+    if (freq == 0) // a pause/rest is a valid "note" with freq=0
     {
         // disable the output, but keep the pwm-ISR going (with the previous
         // frequency) so the audio-state keeps getting updated
@@ -159,12 +172,13 @@ void         channel_1_set_frequency(float freq) {
         AUDIO1_TCCRxA |= _BV(AUDIO1_COMxy1); // enable output, PWM mode
     }
 
-    channel_1_frequency = freq;
+    channel_1_update_interval = (freq >> 16) / (CPU_PRESCALER * 8);
 
+    uint16_t period = pwm_period(freq);
     // set pwm period
-    AUDIO1_ICRx = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
+    AUDIO1_ICRx = period;
     // and duty cycle
-    AUDIO1_OCRxy = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre / 100);
+    AUDIO1_OCRxy = (uint32_t)period * note_timbre / 100;
 }
 
 void channel_1_start(void) {
@@ -183,22 +197,25 @@ void channel_1_stop(void) {
 #endif
 
 #ifdef AUDIO2_PIN_SET
-static float channel_2_frequency = 0.0f;
-void         channel_2_set_frequency(float freq) {
-    if (freq == 0.0f) {
+static audio_freq_q16_t channel_2_frequency       = 0;
+static uint16_t         channel_2_update_interval = 0;
+void                    channel_2_set_frequency(audio_freq_q16_t freq) {
+    if (freq == 0) {
         AUDIO2_TCCRxA &= ~(_BV(AUDIO2_COMxy1) | _BV(AUDIO2_COMxy0));
         return;
     } else {
         AUDIO2_TCCRxA |= _BV(AUDIO2_COMxy1);
     }
 
-    channel_2_frequency = freq;
+    channel_2_frequency       = freq;
+    channel_2_update_interval = (freq >> 16) / (CPU_PRESCALER * 8);
 
-    AUDIO2_ICRx  = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-    AUDIO2_OCRxy = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre / 100);
+    uint16_t period = pwm_period(freq);
+    AUDIO2_ICRx     = period;
+    AUDIO2_OCRxy    = (uint32_t)period * note_timbre / 100;
 }
 
-float channel_2_get_frequency(void) {
+audio_freq_q16_t channel_2_get_frequency(void) {
     return channel_2_frequency;
 }
 
@@ -268,14 +285,14 @@ void audio_driver_start(void) {
 #ifdef AUDIO1_PIN_SET
     channel_1_start();
     if (playing_note) {
-        channel_1_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_frequency_q16(0));
     }
 #endif
 
 #if !defined(AUDIO1_PIN_SET) && defined(AUDIO2_PIN_SET)
     channel_2_start();
     if (playing_note) {
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_2_set_frequency(audio_get_processed_frequency_q16(0));
     }
 #endif
 }
@@ -284,7 +301,7 @@ static volatile uint32_t isr_counter = 0;
 #ifdef AUDIO1_PIN_SET
 ISR(AUDIO1_TIMERx_COMPy_vect) {
     isr_counter++;
-    if (isr_counter < channel_1_frequency / (CPU_PRESCALER * 8)) return;
+    if (isr_counter < channel_1_update_interval) return;
 
     isr_counter        = 0;
     bool state_changed = audio_update_state();
@@ -298,10 +315,10 @@ ISR(AUDIO1_TIMERx_COMPy_vect) {
     }
 
     if (state_changed) {
-        channel_1_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_frequency_q16(0));
 #    ifdef AUDIO2_PIN_SET
         if (audio_get_number_of_active_tones() > 1) {
-            channel_2_set_frequency(audio_get_processed_frequency(1));
+            channel_2_set_frequency(audio_get_processed_frequency_q16(1));
         } else {
             channel_2_stop();
         }
@@ -313,7 +330,7 @@ ISR(AUDIO1_TIMERx_COMPy_vect) {
 #if !defined(AUDIO1_PIN_SET) && defined(AUDIO2_PIN_SET)
 ISR(AUDIO2_TIMERx_COMPy_vect) {
     isr_counter++;
-    if (isr_counter < channel_2_frequency / (CPU_PRESCALER * 8)) return;
+    if (isr_counter < channel_2_update_interval) return;
 
     isr_counter        = 0;
     bool state_changed = audio_update_state();
@@ -324,7 +341,7 @@ ISR(AUDIO2_TIMERx_COMPy_vect) {
     }
 
     if (state_changed) {
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_2_set_frequency(audio_get_processed_frequency_q16(0));
     }
 }
 #endif
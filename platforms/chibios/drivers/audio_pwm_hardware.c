@@ -31,17 +31,17 @@ static PWMConfig pwmCFG = {.frequency = AUDIO_PWM_COUNTER_FREQUENCY, /* PWM cloc
                            .callback  = NULL,
                            .channels  = {[(AUDIO_PWM_CHANNEL - 1)] = {.mode = PWM_OUTPUT_ACTIVE_HIGH, .callback = NULL}}};
 
-static float channel_1_frequency = 0.0f;
+static audio_freq_q16_t channel_1_frequency = 0;
 
-void channel_1_set_frequency(float freq) {
+void channel_1_set_frequency(audio_freq_q16_t freq) {
     channel_1_frequency = freq;
 
-    if (freq <= 0.0) {
+    if (freq == 0) {
         // a pause/rest has freq=0
         return;
     }
 
-    pwmcnt_t period = (pwmCFG.frequency / freq);
+    pwmcnt_t period = ((uint64_t)pwmCFG.frequency << 16) / freq;
     chSysLockFromISR();
     pwmChangePeriodI(&AUDIO_PWM_DRIVER, period);
     pwmEnableChannelI(&AUDIO_PWM_DRIVER, AUDIO_PWM_CHANNEL - 1,
@@ -50,7 +50,7 @@ void channel_1_set_frequency(float freq) {
     chSysUnlockFromISR();
 }
 
-float channel_1_get_frequency(void) {
+audio_freq_q16_t channel_1_get_frequency(void) {
     return channel_1_frequency;
 }
 
@@ -69,10 +69,10 @@ static void            audio_callback(virtual_timer_t *vtp, void *p);
 // a regular timer task, that checks the note to be currently played and updates
 // the pwm to output that frequency.
 static void audio_callback(virtual_timer_t *vtp, void *p) {
-    float freq; // TODO: freq_alt
+    audio_freq_q16_t freq; // TODO: freq_alt
 
     if (audio_update_state()) {
-        freq = audio_get_processed_frequency(0); // freq_alt would be index=1
+        freq = audio_get_processed_frequency_q16(0); // freq_alt would be index=1
         channel_1_set_frequency(freq);
     }
 
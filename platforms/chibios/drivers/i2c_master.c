@@ -73,6 +73,23 @@
 #    define I2C_DRIVER I2CD1
 #endif
 
+#if defined(I2C_QUEUE_ENABLE) && (I2C_USE_MUTUAL_EXCLUSION != TRUE)
+#    error "I2C_QUEUE_ENABLE requires I2C_USE_MUTUAL_EXCLUSION to be TRUE in halconf.h"
+#endif
+#if defined(POINTING_DEVICE_MOTION_INTERRUPT) && (I2C_USE_MUTUAL_EXCLUSION != TRUE)
+#    error "POINTING_DEVICE_MOTION_INTERRUPT requires I2C_USE_MUTUAL_EXCLUSION to be TRUE in halconf.h"
+#endif
+
+// Transfers may be issued from the I2C queue's worker thread or the pointing device's motion sampling thread as well
+// as the main thread
+#if (defined(I2C_QUEUE_ENABLE) || defined(POINTING_DEVICE_MOTION_INTERRUPT)) && (I2C_USE_MUTUAL_EXCLUSION == TRUE)
+#    define i2c_acquire() i2cAcquireBus(&I2C_DRIVER)
+#    define i2c_release() i2cReleaseBus(&I2C_DRIVER)
+#else
+#    define i2c_acquire()
+#    define i2c_release()
+#endif
+
 #ifdef USE_GPIOV1
 #    ifndef I2C1_SCL_PAL_MODE
 #        define I2C1_SCL_PAL_MODE PAL_MODE_ALTERNATE_OPENDRAIN
@@ -158,20 +175,27 @@ i2c_status_t i2c_start(uint8_t address) {
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = address;
+    i2c_acquire();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = address;
+    i2c_acquire();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
+    i2c_acquire();
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
     uint8_t complete_packet[length + 1];
@@ -181,11 +205,14 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
     complete_packet[0] = regaddr;
 
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 1, 0, 0, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
 }
 
 i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
+    i2c_acquire();
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
     uint8_t complete_packet[length + 2];
@@ -196,24 +223,84 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
     complete_packet[1] = regaddr & 0xFF;
 
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 2, 0, 0, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
+    i2c_acquire();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
 }
 
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
+    i2c_acquire();
     i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
     msg_t   status             = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), register_packet, 2, data, length, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
 }
 
 void i2c_stop(void) {
     i2cStop(&I2C_DRIVER);
 }
+
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+
+#    ifndef I2C_QUEUE_THREAD_STACK_SIZE
+#        define I2C_QUEUE_THREAD_STACK_SIZE 256
+#    endif
+
+static THD_WORKING_AREA(i2c_queue_thread_wa, I2C_QUEUE_THREAD_STACK_SIZE);
+static binary_semaphore_t i2c_queue_pending;
+static binary_semaphore_t i2c_queue_completed;
+
+static THD_FUNCTION(i2c_queue_thread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_queue");
+    while (true) {
+        chBSemWait(&i2c_queue_pending);
+        i2c_queue_process();
+    }
+}
+
+void i2c_queue_backend_kick(void) {
+    static bool is_started = false;
+    if (!is_started) {
+        is_started = true;
+        chBSemObjectInit(&i2c_queue_pending, true);
+        chBSemObjectInit(&i2c_queue_completed, true);
+        // Above the main thread so the next transfer starts as soon as the previous one completes
+        chThdCreateStatic(i2c_queue_thread_wa, sizeof(i2c_queue_thread_wa), NORMALPRIO + 1, i2c_queue_thread, NULL);
+    }
+    chBSemSignal(&i2c_queue_pending);
+}
+
+// Waiters always check the queue again after waking, so a completion signalled before they wait is not lost, and a
+// stale one only costs an extra check
+void i2c_queue_backend_wait(void) {
+    chBSemWait(&i2c_queue_completed);
+}
+
+void i2c_queue_backend_complete(void) {
+    chBSemSignal(&i2c_queue_completed);
+}
+
+i2c_status_t i2c_queue_backend_transmit(uint8_t address, const uint8_t* data, uint16_t length) {
+    i2c_acquire();
+    i2cStart(&I2C_DRIVER, &i2cconfig);
+    msg_t        status = i2cMasterTransmitTimeout(&I2C_DRIVER, (address >> 1), data, length, 0, 0, TIME_MS2I(I2C_QUEUE_TIMEOUT));
+    i2c_status_t result = i2c_epilogue(status);
+    i2c_release();
+    return result;
+}
+#endif
@@ -0,0 +1,63 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include <hal.h>
+
+#include "pointing_device.h"
+
+#if !defined(PAL_USE_CALLBACKS) || (PAL_USE_CALLBACKS != TRUE)
+#    error "POINTING_DEVICE_MOTION_INTERRUPT requires PAL_USE_CALLBACKS to be TRUE in halconf.h"
+#endif
+
+#ifndef POINTING_DEVICE_MOTION_THREAD_STACK_SIZE
+#    define POINTING_DEVICE_MOTION_THREAD_STACK_SIZE 256
+#endif
+
+#ifndef POINTING_DEVICE_MOTION_SAMPLE_INTERVAL_US
+#    define POINTING_DEVICE_MOTION_SAMPLE_INTERVAL_US 1000
+#endif
+
+static THD_WORKING_AREA(pointing_device_motion_thread_wa, POINTING_DEVICE_MOTION_THREAD_STACK_SIZE);
+static binary_semaphore_t pointing_device_motion_pending;
+
+static void pointing_device_motion_callback(void *arg) {
+    (void)arg;
+    chSysLockFromISR();
+    chBSemSignalI(&pointing_device_motion_pending);
+    chSysUnlockFromISR();
+}
+
+// Sensors are read over SPI or I2C, which cannot be done from the interrupt itself, so the interrupt wakes this thread
+static THD_FUNCTION(pointing_device_motion_thread, arg) {
+    (void)arg;
+    chRegSetThreadName("pointing_motion");
+    while (true) {
+        chBSemWait(&pointing_device_motion_pending);
+
+        // Keep reading at the sample interval until the sensor has no more motion to report
+        systime_t time = chVTGetSystemTimeX();
+        while (pointing_device_motion_pin_active()) {
+            pointing_device_motion_sample();
+            time = chThdSleepUntilWindowed(time, chTimeAddX(time, TIME_US2I(POINTING_DEVICE_MOTION_SAMPLE_INTERVAL_US)));
+        }
+    }
+}
+
+void pointing_device_motion_backend_init(void) {
+    // Not taken, so motion pending from before the interrupt was armed is read straight away
+    chBSemObjectInit(&pointing_device_motion_pending, false);
+    // Above the main thread so that motion is read as soon as the sensor signals it
+    chThdCreateStatic(pointing_device_motion_thread_wa, sizeof(pointing_device_motion_thread_wa), NORMALPRIO + 1, pointing_device_motion_thread, NULL);
+
+#ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+    palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_FALLING_EDGE);
+#else
+    palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_RISING_EDGE);
+#endif
+    palSetLineCallback(POINTING_DEVICE_MOTION_PIN, pointing_device_motion_callback, NULL);
+}
+
+void pointing_device_motion_backend_task(void) {
+    // Sampling is driven by the motion interrupt
+}
@@ -0,0 +1,28 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+
+#include "rgblight.h"
+
+static virtual_timer_t rgblight_animation_timer;
+static bool            rgblight_animation_timer_initialized = false;
+
+static void rgblight_animation_timer_callback(struct ch_virtual_timer *timer, void *arg) {
+    (void)timer;
+    (void)arg;
+    rgblight_animation_timer_expired();
+}
+
+void rgblight_animation_timer_init(void) {
+    // rgblight_timer_init() can be called again, and an armed timer must not be reinitialised
+    if (!rgblight_animation_timer_initialized) {
+        chVTObjectInit(&rgblight_animation_timer);
+        rgblight_animation_timer_initialized = true;
+    }
+}
+
+void rgblight_animation_timer_schedule(uint16_t delay_ms) {
+    // Replaces any frame still pending, e.g. after a mode change
+    chVTSet(&rgblight_animation_timer, TIME_MS2I(delay_ms), rgblight_animation_timer_callback, NULL);
+}
@@ -26,6 +26,41 @@ static pin_t currentSlavePin;
 
 static SPIConfig spiConfig;
 
+#if defined(SPI_QUEUE_ENABLE) && (SPI_USE_MUTUAL_EXCLUSION != TRUE)
+#    error "SPI_QUEUE_ENABLE requires SPI_USE_MUTUAL_EXCLUSION to be TRUE in halconf.h"
+#endif
+#if defined(POINTING_DEVICE_MOTION_INTERRUPT) && (SPI_USE_MUTUAL_EXCLUSION != TRUE)
+#    error "POINTING_DEVICE_MOTION_INTERRUPT requires SPI_USE_MUTUAL_EXCLUSION to be TRUE in halconf.h"
+#endif
+
+// Transfers may be issued from the pointing device's motion sampling thread or the queue thread as well as the main
+// thread, so the bus is held from spi_start() to spi_stop()
+#if (defined(SPI_QUEUE_ENABLE) || defined(POINTING_DEVICE_MOTION_INTERRUPT)) && (SPI_USE_MUTUAL_EXCLUSION == TRUE)
+static thread_t *spiOwner = NULL;
+
+static bool spi_acquire(void) {
+    if (spiOwner == chThdGetSelfX()) {
+        return false;
+    }
+    spiAcquireBus(&SPI_DRIVER);
+    spiOwner = chThdGetSelfX();
+    return true;
+}
+
+static void spi_release(void) {
+    spiOwner = NULL;
+    spiReleaseBus(&SPI_DRIVER);
+}
+
+static bool spi_is_owner(void) {
+    return spiOwner == chThdGetSelfX();
+}
+#else
+#    define spi_acquire() true
+#    define spi_release()
+#    define spi_is_owner() true
+#endif
+
 __attribute__((weak)) void spi_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -63,7 +98,7 @@ __attribute__((weak)) void spi_init(void) {
     }
 }
 
-bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+static bool spi_start_unlocked(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     if (spiStarted) {
         return false;
     }
@@ -291,6 +326,17 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     return true;
 }
 
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    if (!spi_acquire()) {
+        return false;
+    }
+    if (!spi_start_unlocked(slavePin, lsbFirst, mode, divisor)) {
+        spi_release();
+        return false;
+    }
+    return true;
+}
+
 spi_status_t spi_write(uint8_t data) {
     uint8_t rxData;
     spiExchange(&SPI_DRIVER, 1, &data, &rxData);
@@ -316,7 +362,7 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
 }
 
 void spi_stop(void) {
-    if (spiStarted) {
+    if (spiStarted && spi_is_owner()) {
 #if SPI_SELECT_MODE == SPI_SELECT_MODE_NONE
         if (currentSlavePin != NO_PIN) {
             writePinHigh(currentSlavePin);
@@ -325,5 +371,51 @@ void spi_stop(void) {
         spiUnselect(&SPI_DRIVER);
         spiStop(&SPI_DRIVER);
         spiStarted = false;
+        spi_release();
+    }
+}
+
+#ifdef SPI_QUEUE_ENABLE
+#    include "spi_queue.h"
+
+#    ifndef SPI_QUEUE_THREAD_STACK_SIZE
+#        define SPI_QUEUE_THREAD_STACK_SIZE 256
+#    endif
+
+static THD_WORKING_AREA(spi_queue_thread_wa, SPI_QUEUE_THREAD_STACK_SIZE);
+static binary_semaphore_t spi_queue_pending;
+static binary_semaphore_t spi_queue_completed;
+
+// The transfers themselves use the default backend, spiSend() and spiReceive() suspend this thread while the LLD moves
+// the data by DMA
+static THD_FUNCTION(spi_queue_thread, arg) {
+    (void)arg;
+    chRegSetThreadName("spi_queue");
+    while (true) {
+        chBSemWait(&spi_queue_pending);
+        spi_queue_process();
     }
 }
+
+void spi_queue_backend_kick(void) {
+    static bool is_started = false;
+    if (!is_started) {
+        is_started = true;
+        chBSemObjectInit(&spi_queue_pending, true);
+        chBSemObjectInit(&spi_queue_completed, true);
+        // Above the main thread so the next transfer starts as soon as the previous one completes
+        chThdCreateStatic(spi_queue_thread_wa, sizeof(spi_queue_thread_wa), NORMALPRIO + 1, spi_queue_thread, NULL);
+    }
+    chBSemSignal(&spi_queue_pending);
+}
+
+// Waiters always check the queue again after waking, so a completion signalled before they wait is not lost, and a
+// stale one only costs an extra check
+void spi_queue_backend_wait(void) {
+    chBSemWait(&spi_queue_completed);
+}
+
+void spi_queue_backend_complete(void) {
+    chBSemSignal(&spi_queue_completed);
+}
+#endif
@@ -1,4 +1,5 @@
 #include "ws2812.h"
+#include "ws2812_encode.h"
 
 #include "gpio.h"
 #include "chibios_config.h"
@@ -83,24 +84,11 @@ void ws2812_setleds(rgb_led_t *ledarray, uint16_t leds) {
     chSysLock();
 
     for (uint8_t i = 0; i < leds; i++) {
-        // WS2812 protocol dictates grb order
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].r);
-        sendByte(ledarray[i].b);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-        sendByte(ledarray[i].r);
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].b);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-        sendByte(ledarray[i].b);
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].r);
-#endif
-
-#ifdef RGBW
-        sendByte(ledarray[i].w);
-#endif
+        uint8_t channels[WS2812_CHANNELS];
+        ws2812_encode_channels(&ledarray[i], channels);
+        for (uint8_t j = 0; j < WS2812_CHANNELS; j++) {
+            sendByte(channels[j]);
+        }
     }
 
     wait_ns(WS2812_RES);
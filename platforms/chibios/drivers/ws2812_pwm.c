@@ -1,15 +1,11 @@
+#include <string.h>
 #include "ws2812.h"
+#include "ws2812_encode.h"
 #include "gpio.h"
 #include "chibios_config.h"
 
 /* Adapted from https://github.com/joewa/WS2812-LED-Driver_ChibiOS/ */
 
-#ifdef RGBW
-#    define WS2812_CHANNELS 4
-#else
-#    define WS2812_CHANNELS 3
-#endif
-
 #ifndef WS2812_PWM_DRIVER
 #    define WS2812_PWM_DRIVER PWMD2 // TIMx
 #endif
@@ -134,139 +130,13 @@
  * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given bit
  *
  * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] byte:                 The byte number [0, 2]
+ * @param[in] byte:                 The byte number [0, @ref WS2812_CHANNELS)
  * @param[in] bit:                  The bit number [0, 7]
  *
  * @return                          The bit index
  */
 #define WS2812_BIT(led, byte, bit) (WS2812_COLOR_BITS * (led) + 8 * (byte) + (7 - (bit)))
 
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given red bit
- *
- * @note    The red byte is the middle byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_RED_BIT(led, bit) WS2812_BIT((led), 1, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given green bit
- *
- * @note    The red byte is the first byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_GREEN_BIT(led, bit) WS2812_BIT((led), 0, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given blue bit
- *
- * @note    The red byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 2, (bit))
-
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given red bit
- *
- * @note    The red byte is the middle byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_RED_BIT(led, bit) WS2812_BIT((led), 0, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given green bit
- *
- * @note    The red byte is the first byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_GREEN_BIT(led, bit) WS2812_BIT((led), 1, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given blue bit
- *
- * @note    The red byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 2, (bit))
-
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given red bit
- *
- * @note    The red byte is the middle byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_RED_BIT(led, bit) WS2812_BIT((led), 2, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given green bit
- *
- * @note    The red byte is the first byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_GREEN_BIT(led, bit) WS2812_BIT((led), 1, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given blue bit
- *
- * @note    The red byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_COUNT)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 0, (bit))
-#endif
-
-#ifdef RGBW
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given white bit
- *
- * @note    The white byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref WS2812_LED_N)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_WHITE_BIT(led, bit) WS2812_BIT((led), 3, (bit))
-#endif
-
 /* --- PRIVATE VARIABLES ---------------------------------------------------- */
 
 // STM32F2XX, STM32F4XX and STM32F7XX do NOT zero pad DMA transfers of unequal data width. Buffer width must match TIMx CCR.
@@ -293,6 +163,17 @@ typedef uint8_t ws2812_buffer_t;
 
 static ws2812_buffer_t ws2812_frame_buffer[WS2812_BIT_N + 1]; /**< Buffer for a frame */
 
+#define WS2812_NIBBLE_BIT(nibble, bit) ((((nibble) >> (bit)) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0)
+#define WS2812_NIBBLE(nibble) {WS2812_NIBBLE_BIT(nibble, 3), WS2812_NIBBLE_BIT(nibble, 2), WS2812_NIBBLE_BIT(nibble, 1), WS2812_NIBBLE_BIT(nibble, 0)}
+
+/**
+ * @brief   Duty cycles for the four bits of each possible nibble, most significant bit first
+ */
+static const ws2812_buffer_t ws2812_nibble_lut[16][4] = {
+    WS2812_NIBBLE(0),  WS2812_NIBBLE(1),  WS2812_NIBBLE(2),  WS2812_NIBBLE(3),  WS2812_NIBBLE(4),  WS2812_NIBBLE(5),  WS2812_NIBBLE(6),  WS2812_NIBBLE(7),
+    WS2812_NIBBLE(8),  WS2812_NIBBLE(9),  WS2812_NIBBLE(10), WS2812_NIBBLE(11), WS2812_NIBBLE(12), WS2812_NIBBLE(13), WS2812_NIBBLE(14), WS2812_NIBBLE(15),
+};
+
 /* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
 /*
  * Gedanke: Double-buffer type transactions: double buffer transfers using two memory pointers for
@@ -358,23 +239,13 @@ void ws2812_init(void) {
     pwmEnableChannel(&WS2812_PWM_DRIVER, WS2812_PWM_CHANNEL - 1, 0); // Initial period is 0; output will be low until first duty cycle is DMA'd in
 }
 
-void ws2812_write_led(uint16_t led_number, uint8_t r, uint8_t g, uint8_t b) {
-    // Write color to frame buffer
-    for (uint8_t bit = 0; bit < 8; bit++) {
-        ws2812_frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-    }
-}
-void ws2812_write_led_rgbw(uint16_t led_number, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
-    // Write color to frame buffer
-    for (uint8_t bit = 0; bit < 8; bit++) {
-        ws2812_frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-#ifdef RGBW
-        ws2812_frame_buffer[WS2812_WHITE_BIT(led_number, bit)] = ((w >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-#endif
+static void ws2812_write_led(uint16_t led_number, const uint8_t channels[WS2812_CHANNELS]) {
+    // Write the wire bytes to the frame buffer, a nibble at a time
+    ws2812_buffer_t* bits = &ws2812_frame_buffer[WS2812_BIT(led_number, 0, 7)];
+    for (uint8_t i = 0; i < WS2812_CHANNELS; i++) {
+        memcpy(bits, ws2812_nibble_lut[channels[i] >> 4], sizeof(ws2812_nibble_lut[0]));
+        memcpy(bits + 4, ws2812_nibble_lut[channels[i] & 0x0F], sizeof(ws2812_nibble_lut[0]));
+        bits += 8;
     }
 }
 
@@ -387,10 +258,9 @@ void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
     }
 
     for (uint16_t i = 0; i < leds; i++) {
-#ifdef RGBW
-        ws2812_write_led_rgbw(i, ledarray[i].r, ledarray[i].g, ledarray[i].b, ledarray[i].w);
-#else
-        ws2812_write_led(i, ledarray[i].r, ledarray[i].g, ledarray[i].b);
-#endif
+        uint8_t channels[WS2812_CHANNELS];
+        if (ws2812_encode_led_changed(i, &ledarray[i], channels)) {
+            ws2812_write_led(i, channels);
+        }
     }
 }
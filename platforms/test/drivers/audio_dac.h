@@ -0,0 +1,7 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// Same buffer size, sample range and quality presets as on hardware, so that the host renders the identical sample stream
+#include "../../chibios/drivers/audio_dac.h"
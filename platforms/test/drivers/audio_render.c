@@ -0,0 +1,103 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdio.h>
+#include <string.h>
+#include "audio.h"
+#include "audio_render.h"
+
+#define AUDIO_RENDER_BLOCK_SIZE (AUDIO_DAC_BUFFER_SIZE / 2)
+
+void advance_time(uint32_t ms);
+
+static bool     running = false;
+static uint16_t block[AUDIO_RENDER_BLOCK_SIZE];
+static size_t   block_position = AUDIO_RENDER_BLOCK_SIZE;
+// Playback time not yet passed on to the timer, in 1/AUDIO_RENDER_SAMPLE_RATE ms
+static uint32_t pending_time = 0;
+
+void audio_driver_initialize(void) {
+    running        = false;
+    block_position = AUDIO_RENDER_BLOCK_SIZE;
+    pending_time   = 0;
+}
+
+void audio_driver_start(void) {
+    running = true;
+    audio_synth_start();
+}
+
+void audio_driver_stop(void) {
+    audio_synth_stop();
+}
+
+static void render_block(void) {
+    if (running) {
+        if (audio_synth_render(block, AUDIO_RENDER_BLOCK_SIZE)) {
+            running = false;
+        }
+    } else {
+        for (size_t i = 0; i < AUDIO_RENDER_BLOCK_SIZE; i++) {
+            block[i] = AUDIO_DAC_OFF_VALUE;
+        }
+    }
+    block_position = 0;
+
+    pending_time += AUDIO_RENDER_BLOCK_SIZE * 1000;
+    advance_time(pending_time / AUDIO_RENDER_SAMPLE_RATE);
+    pending_time %= AUDIO_RENDER_SAMPLE_RATE;
+}
+
+size_t audio_render(uint16_t *samples, size_t count) {
+    size_t written = 0;
+    while (written < count) {
+        if (block_position == AUDIO_RENDER_BLOCK_SIZE) {
+            render_block();
+        }
+        size_t length = AUDIO_RENDER_BLOCK_SIZE - block_position;
+        if (length > count - written) {
+            length = count - written;
+        }
+        memcpy(&samples[written], &block[block_position], length * sizeof(uint16_t));
+        block_position += length;
+        written += length;
+    }
+    return written;
+}
+
+static void write_le(FILE *file, uint32_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        fputc((value >> (8 * i)) & 0xFF, file);
+    }
+}
+
+bool audio_render_write_wav(const char *path, const uint16_t *samples, size_t count) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    uint32_t data_size = count * sizeof(int16_t);
+    fputs("RIFF", file);
+    write_le(file, 36 + data_size, 4);
+    fputs("WAVEfmt ", file);
+    write_le(file, 16, 4);                                  // format chunk size
+    write_le(file, 1, 2);                                   // PCM
+    write_le(file, 1, 2);                                   // mono
+    write_le(file, AUDIO_RENDER_SAMPLE_RATE, 4);            // sample rate
+    write_le(file, AUDIO_RENDER_SAMPLE_RATE * 2, 4);        // byte rate
+    write_le(file, 2, 2);                                   // block align
+    write_le(file, 16, 2);                                  // bits per sample
+    fputs("data", file);
+    write_le(file, data_size, 4);
+
+    for (size_t i = 0; i < count; i++) {
+        // Centred on AUDIO_DAC_OFF_VALUE, so that silence is zero
+        int32_t value = ((int32_t)samples[i] - (int32_t)AUDIO_DAC_OFF_VALUE) * 65535 / (int32_t)AUDIO_DAC_SAMPLE_MAX;
+        if (value > INT16_MAX) value = INT16_MAX;
+        if (value < INT16_MIN) value = INT16_MIN;
+        write_le(file, (uint16_t)(int16_t)value, 2);
+    }
+
+    return fclose(file) == 0;
+}
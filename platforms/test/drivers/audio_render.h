@@ -0,0 +1,32 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "audio_synth.h"
+
+/**
+ * Sample rate of the rendered stream, in Hz - the rate the DAC consumes samples at on hardware.
+ */
+#define AUDIO_RENDER_SAMPLE_RATE AUDIO_SYNTH_OUTPUT_RATE
+
+/**
+ * @brief Render the next `count` output samples, advancing the test timer by the time they take to play.
+ *
+ * Samples are generated in blocks of AUDIO_DAC_BUFFER_SIZE / 2 with audio_update_state() called after each
+ * block, exactly as the 'dac_additive' driver does from its DMA callback. While the driver is stopped, the
+ * output holds AUDIO_DAC_OFF_VALUE.
+ *
+ * @return the number of samples written, always `count`
+ */
+size_t audio_render(uint16_t *samples, size_t count);
+
+/**
+ * @brief Write rendered samples to a 16 bit mono WAV file at AUDIO_RENDER_SAMPLE_RATE.
+ *
+ * @return false if the file could not be written
+ */
+bool audio_render_write_wav(const char *path, const uint16_t *samples, size_t count);
@@ -0,0 +1,21 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint8_t pin_t;
+typedef int16_t spi_status_t;
+
+#define SPI_STATUS_SUCCESS (0)
+#define SPI_STATUS_ERROR (-1)
+#define SPI_STATUS_TIMEOUT (-2)
+
+void         spi_init(void);
+bool         spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor);
+spi_status_t spi_write(uint8_t data);
+spi_status_t spi_read(void);
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
+spi_status_t spi_receive(uint8_t *data, uint16_t length);
+void         spi_stop(void);
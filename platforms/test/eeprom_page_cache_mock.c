@@ -0,0 +1,29 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "eeprom_page_cache.h"
+#include "eeprom_page_cache_mock.h"
+
+uint8_t  MockEepromBuf[EXTERNAL_EEPROM_BYTE_COUNT] = {0};
+uint32_t mock_eeprom_read_count                    = 0;
+uint32_t mock_eeprom_write_count                   = 0;
+
+void mock_eeprom_reset(void) {
+    memset(MockEepromBuf, 0, sizeof(MockEepromBuf));
+    mock_eeprom_read_count  = 0;
+    mock_eeprom_write_count = 0;
+}
+
+void eeprom_page_cache_backend_read(uintptr_t addr, uint8_t *buf, size_t len) {
+    ++mock_eeprom_read_count;
+    memcpy(buf, &MockEepromBuf[addr], len);
+}
+
+void eeprom_page_cache_backend_write(uintptr_t addr, const uint8_t *buf, size_t len) {
+    ++mock_eeprom_write_count;
+    // Page writes wrap around within the page on real devices, so never allow a write to cross a page boundary
+    if ((addr % EXTERNAL_EEPROM_PAGE_SIZE) + len > EXTERNAL_EEPROM_PAGE_SIZE) {
+        return;
+    }
+    memcpy(&MockEepromBuf[addr], buf, len);
+}
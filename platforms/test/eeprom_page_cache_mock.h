@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern uint8_t MockEepromBuf[EXTERNAL_EEPROM_BYTE_COUNT];
+
+// Number of bus transactions issued to the mock EEPROM
+extern uint32_t mock_eeprom_read_count;
+extern uint32_t mock_eeprom_write_count;
+
+void mock_eeprom_reset(void);
@@ -0,0 +1,145 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom_page_cache.h"
+#include "eeprom_page_cache_mock.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+class EepromPageCacheTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        mock_eeprom_reset();
+        eeprom_page_cache_invalidate();
+    }
+};
+
+TEST_F(EepromPageCacheTest, ReadFetchesWholePage) {
+    MockEepromBuf[5]                             = 0x42;
+    MockEepromBuf[EXTERNAL_EEPROM_PAGE_SIZE - 1] = 0x24;
+
+    uint8_t value = 0;
+    eeprom_page_cache_read(&value, 5, 1);
+    EXPECT_EQ(value, 0x42);
+    EXPECT_EQ(mock_eeprom_read_count, 1);
+
+    // Remainder of the page is served from the cache
+    eeprom_page_cache_read(&value, EXTERNAL_EEPROM_PAGE_SIZE - 1, 1);
+    EXPECT_EQ(value, 0x24);
+    EXPECT_EQ(mock_eeprom_read_count, 1);
+
+    // Next page requires another bus transaction
+    eeprom_page_cache_read(&value, EXTERNAL_EEPROM_PAGE_SIZE, 1);
+    EXPECT_EQ(mock_eeprom_read_count, 2);
+}
+
+TEST_F(EepromPageCacheTest, WriteIsDeferredUntilFlush) {
+    uint8_t value = 0x42;
+    eeprom_page_cache_write(&value, 3, 1);
+    EXPECT_EQ(mock_eeprom_write_count, 0);
+    EXPECT_EQ(MockEepromBuf[3], 0);
+
+    uint8_t readback = 0;
+    eeprom_page_cache_read(&readback, 3, 1);
+    EXPECT_EQ(readback, 0x42);
+
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_write_count, 1);
+    EXPECT_EQ(MockEepromBuf[3], 0x42);
+
+    // Nothing left to flush
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_write_count, 1);
+}
+
+TEST_F(EepromPageCacheTest, UnchangedWriteIsSkipped) {
+    MockEepromBuf[7] = 0x11;
+
+    uint8_t value = 0x11;
+    eeprom_page_cache_write(&value, 7, 1);
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_write_count, 0);
+}
+
+TEST_F(EepromPageCacheTest, WritesToSamePageCoalesce) {
+    for (uint8_t i = 0; i < 10; ++i) {
+        eeprom_page_cache_write(&i, i, 1);
+    }
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_read_count, 1);
+    EXPECT_EQ(mock_eeprom_write_count, 1);
+    for (uint8_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(MockEepromBuf[i], i);
+    }
+}
+
+TEST_F(EepromPageCacheTest, WriteSpanningPages) {
+    uint8_t data[EXTERNAL_EEPROM_PAGE_SIZE + 8];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i + 1);
+    }
+
+    eeprom_page_cache_write(data, EXTERNAL_EEPROM_PAGE_SIZE - 4, sizeof(data));
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_write_count, 3);
+    EXPECT_EQ(memcmp(&MockEepromBuf[EXTERNAL_EEPROM_PAGE_SIZE - 4], data, sizeof(data)), 0);
+}
+
+TEST_F(EepromPageCacheTest, FullPageWriteSkipsRead) {
+    uint8_t data[EXTERNAL_EEPROM_PAGE_SIZE];
+    memset(data, 0x5A, sizeof(data));
+
+    eeprom_page_cache_write(data, 2 * EXTERNAL_EEPROM_PAGE_SIZE, sizeof(data));
+    EXPECT_EQ(mock_eeprom_read_count, 0);
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_write_count, 1);
+    EXPECT_EQ(memcmp(&MockEepromBuf[2 * EXTERNAL_EEPROM_PAGE_SIZE], data, sizeof(data)), 0);
+}
+
+TEST_F(EepromPageCacheTest, EvictionWritesBackDirtyPage) {
+    for (uint8_t page = 0; page <= EXTERNAL_EEPROM_CACHE_PAGE_COUNT; ++page) {
+        uint8_t value = page + 1;
+        eeprom_page_cache_write(&value, page * EXTERNAL_EEPROM_PAGE_SIZE, 1);
+    }
+
+    // Least recently used page was evicted to make room
+    EXPECT_EQ(mock_eeprom_write_count, 1);
+    EXPECT_EQ(MockEepromBuf[0], 1);
+
+    eeprom_page_cache_flush();
+    EXPECT_EQ(mock_eeprom_write_count, EXTERNAL_EEPROM_CACHE_PAGE_COUNT + 1);
+    for (uint8_t page = 0; page <= EXTERNAL_EEPROM_CACHE_PAGE_COUNT; ++page) {
+        EXPECT_EQ(MockEepromBuf[page * EXTERNAL_EEPROM_PAGE_SIZE], page + 1);
+    }
+}
+
+TEST_F(EepromPageCacheTest, TaskFlushesAfterDelay) {
+    uint8_t value = 0x42;
+    eeprom_page_cache_write(&value, 0, 1);
+
+    advance_time(EXTERNAL_EEPROM_CACHE_FLUSH_DELAY - 1);
+    eeprom_page_cache_task();
+    EXPECT_EQ(mock_eeprom_write_count, 0);
+
+    advance_time(1);
+    eeprom_page_cache_task();
+    EXPECT_EQ(mock_eeprom_write_count, 1);
+    EXPECT_EQ(MockEepromBuf[0], 0x42);
+}
+
+TEST_F(EepromPageCacheTest, InvalidateRefetches) {
+    uint8_t value = 0;
+    eeprom_page_cache_read(&value, 0, 1);
+    EXPECT_EQ(value, 0);
+
+    MockEepromBuf[0] = 0x42;
+    eeprom_page_cache_invalidate();
+    eeprom_page_cache_read(&value, 0, 1);
+    EXPECT_EQ(value, 0x42);
+    EXPECT_EQ(mock_eeprom_read_count, 2);
+}
@@ -0,0 +1,43 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "i2c_queue.h"
+#include "i2c_queue_mock.h"
+
+mock_i2c_transfer_t mock_i2c_transfers[MOCK_I2C_MAX_TRANSFERS];
+uint32_t            mock_i2c_transfer_count = 0;
+uint32_t            mock_i2c_fail_count     = 0;
+
+void mock_i2c_reset(void) {
+    memset(mock_i2c_transfers, 0, sizeof(mock_i2c_transfers));
+    mock_i2c_transfer_count = 0;
+    mock_i2c_fail_count     = 0;
+}
+
+// Jobs are left pending, as if a background transfer were in progress, until the test calls i2c_queue_process()
+void i2c_queue_backend_kick(void) {}
+
+void i2c_queue_backend_wait(void) {
+    i2c_queue_process();
+}
+
+i2c_status_t i2c_queue_backend_transmit(uint8_t address, const uint8_t *data, uint16_t length) {
+    if (mock_i2c_transfer_count < MOCK_I2C_MAX_TRANSFERS && length <= MOCK_I2C_MAX_LENGTH) {
+        mock_i2c_transfer_t *transfer = &mock_i2c_transfers[mock_i2c_transfer_count];
+        transfer->address             = address;
+        transfer->length              = length;
+        memcpy(transfer->data, data, length);
+    }
+    mock_i2c_transfer_count++;
+
+    if (mock_i2c_fail_count > 0) {
+        mock_i2c_fail_count--;
+        return I2C_STATUS_ERROR;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    (void)timeout;
+    return i2c_queue_backend_transmit(address, data, length);
+}
@@ -0,0 +1,24 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include "i2c_master.h"
+
+#define MOCK_I2C_MAX_TRANSFERS 64
+#define MOCK_I2C_MAX_LENGTH 80
+
+typedef struct {
+    uint8_t  address;
+    uint16_t length;
+    uint8_t  data[MOCK_I2C_MAX_LENGTH];
+} mock_i2c_transfer_t;
+
+// Transfers issued on the mock bus, in order
+extern mock_i2c_transfer_t mock_i2c_transfers[MOCK_I2C_MAX_TRANSFERS];
+extern uint32_t            mock_i2c_transfer_count;
+
+// Number of upcoming transfers which fail with I2C_STATUS_ERROR
+extern uint32_t mock_i2c_fail_count;
+
+void mock_i2c_reset(void);
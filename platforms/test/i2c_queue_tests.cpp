@@ -0,0 +1,113 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "i2c_queue.h"
+#include "i2c_queue_mock.h"
+}
+
+struct completion_t {
+    i2c_status_t status;
+    uintptr_t    context;
+};
+
+static std::vector<completion_t> completions;
+
+static void record_completion(i2c_status_t status, void *context) {
+    completions.push_back({status, (uintptr_t)context});
+}
+
+class I2CQueueTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        i2c_queue_wait();
+        mock_i2c_reset();
+        completions.clear();
+    }
+};
+
+TEST_F(I2CQueueTest, JobsRunInOrderInTheBackground) {
+    const uint8_t data[] = {0x11, 0x22, 0x33};
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0xFD, 0x01, 0, record_completion, (void *)1));
+    EXPECT_TRUE(i2c_queue_write(0x50, 0x10, data, sizeof(data), 0, record_completion, (void *)2));
+
+    // Nothing is sent until the backend gets to it
+    EXPECT_EQ(mock_i2c_transfer_count, 0);
+    EXPECT_FALSE(i2c_queue_is_idle());
+
+    i2c_queue_process();
+    ASSERT_EQ(mock_i2c_transfer_count, 2);
+    EXPECT_EQ(mock_i2c_transfers[0].address, 0x50);
+    EXPECT_EQ(mock_i2c_transfers[0].length, 2);
+    EXPECT_EQ(mock_i2c_transfers[0].data[0], 0xFD);
+    EXPECT_EQ(mock_i2c_transfers[0].data[1], 0x01);
+    EXPECT_EQ(mock_i2c_transfers[1].length, 4);
+    EXPECT_EQ(mock_i2c_transfers[1].data[0], 0x10);
+    EXPECT_EQ(mock_i2c_transfers[1].data[3], 0x33);
+
+    // Callbacks are deferred to the task
+    EXPECT_TRUE(completions.empty());
+    i2c_queue_task();
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].context, 1u);
+    EXPECT_EQ(completions[0].status, I2C_STATUS_SUCCESS);
+    EXPECT_EQ(completions[1].context, 2u);
+    EXPECT_TRUE(i2c_queue_is_idle());
+}
+
+TEST_F(I2CQueueTest, DataIsReadWhenTransferred) {
+    uint8_t data[2] = {0x01, 0x02};
+    i2c_queue_write(0x50, 0x00, data, sizeof(data), 0, NULL, NULL);
+    data[1] = 0x42;
+
+    i2c_queue_process();
+    ASSERT_EQ(mock_i2c_transfer_count, 1);
+    EXPECT_EQ(mock_i2c_transfers[0].data[2], 0x42);
+}
+
+TEST_F(I2CQueueTest, RetriesUntilSuccess) {
+    mock_i2c_fail_count = 2;
+    i2c_queue_write_register(0x50, 0x00, 0xAA, 3, record_completion, NULL);
+    i2c_queue_wait();
+
+    EXPECT_EQ(mock_i2c_transfer_count, 3);
+    ASSERT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions[0].status, I2C_STATUS_SUCCESS);
+}
+
+TEST_F(I2CQueueTest, FailureIsReported) {
+    mock_i2c_fail_count = 5;
+    i2c_queue_write_register(0x50, 0x00, 0xAA, 2, record_completion, NULL);
+    i2c_queue_write_register(0x50, 0x01, 0xBB, 0, record_completion, NULL);
+    i2c_queue_wait();
+
+    // Two attempts at the first job, one at the second
+    EXPECT_EQ(mock_i2c_transfer_count, 3);
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].status, I2C_STATUS_ERROR);
+    EXPECT_EQ(completions[1].status, I2C_STATUS_ERROR);
+}
+
+TEST_F(I2CQueueTest, FullQueueWaitsForSpace) {
+    for (int i = 0; i < I2C_QUEUE_SIZE; i++) {
+        i2c_queue_write_register(0x50, i, 0, 0, NULL, NULL);
+    }
+    EXPECT_EQ(mock_i2c_transfer_count, 0);
+
+    i2c_queue_write_register(0x50, I2C_QUEUE_SIZE, 0, 0, NULL, NULL);
+    EXPECT_EQ(mock_i2c_transfer_count, I2C_QUEUE_SIZE);
+
+    i2c_queue_wait();
+    ASSERT_EQ(mock_i2c_transfer_count, I2C_QUEUE_SIZE + 1);
+    for (int i = 0; i <= I2C_QUEUE_SIZE; i++) {
+        EXPECT_EQ(mock_i2c_transfers[i].data[0], i);
+    }
+}
+
+TEST_F(I2CQueueTest, OversizedJobIsRejected) {
+    static uint8_t data[I2C_QUEUE_MAX_LENGTH + 1];
+    EXPECT_FALSE(i2c_queue_write(0x50, 0x00, data, sizeof(data), 0, NULL, NULL));
+    EXPECT_TRUE(i2c_queue_is_idle());
+}
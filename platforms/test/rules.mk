@@ -23,3 +23,42 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+eeprom_page_cache_DEFS := \
+	-DEXTERNAL_EEPROM_BYTE_COUNT=1024 \
+	-DEXTERNAL_EEPROM_PAGE_SIZE=32 \
+	-DEXTERNAL_EEPROM_CACHE_PAGE_COUNT=4
+eeprom_page_cache_INC := \
+	$(TOP_DIR)/drivers/eeprom/ \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/
+eeprom_page_cache_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_page_cache.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_page_cache_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_page_cache_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+ws2812_encode_DEFS := -DWS2812_LED_COUNT=150
+ws2812_encode_INC := \
+	$(TOP_DIR)/drivers/ \
+	$(TOP_DIR)/quantum/
+ws2812_encode_SRC := \
+	$(TOP_DIR)/drivers/ws2812_encode.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/ws2812_encode_tests.cpp
+
+i2c_queue_INC := \
+	$(TOP_DIR)/drivers/ \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/ \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/
+i2c_queue_SRC := \
+	$(TOP_DIR)/drivers/i2c_queue.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/i2c_queue_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/i2c_queue_mock.c
+
+spi_queue_INC := \
+	$(TOP_DIR)/drivers/ \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/ \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/
+spi_queue_SRC := \
+	$(TOP_DIR)/drivers/spi_queue.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/spi_queue_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/spi_queue_mock.c
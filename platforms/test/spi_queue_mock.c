@@ -0,0 +1,84 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "spi_queue.h"
+#include "spi_queue_mock.h"
+
+mock_spi_transaction_t mock_spi_transactions[MOCK_SPI_MAX_TRANSACTIONS];
+uint32_t               mock_spi_transaction_count = 0;
+uint8_t                mock_spi_rx_value          = 0;
+uint32_t               mock_spi_fail_count        = 0;
+uint32_t               mock_spi_start_fail_count  = 0;
+
+static mock_spi_transaction_t *current = NULL;
+
+void mock_spi_reset(void) {
+    memset(mock_spi_transactions, 0, sizeof(mock_spi_transactions));
+    mock_spi_transaction_count = 0;
+    mock_spi_rx_value          = 0;
+    mock_spi_fail_count        = 0;
+    mock_spi_start_fail_count  = 0;
+    current                    = NULL;
+}
+
+static spi_status_t mock_spi_result(void) {
+    if (mock_spi_fail_count > 0) {
+        mock_spi_fail_count--;
+        return SPI_STATUS_ERROR;
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+// Jobs are left pending, as if a background transfer were in progress, until the test calls spi_queue_process()
+void spi_queue_backend_kick(void) {}
+
+void spi_queue_backend_wait(void) {
+    spi_queue_process();
+}
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    (void)lsbFirst;
+    if (current != NULL) {
+        return false;
+    }
+    if (mock_spi_start_fail_count > 0) {
+        mock_spi_start_fail_count--;
+        return false;
+    }
+
+    static mock_spi_transaction_t overflow;
+    current = mock_spi_transaction_count < MOCK_SPI_MAX_TRANSACTIONS ? &mock_spi_transactions[mock_spi_transaction_count] : &overflow;
+    memset(current, 0, sizeof(*current));
+    current->cs_pin  = slavePin;
+    current->mode    = mode;
+    current->divisor = divisor;
+    mock_spi_transaction_count++;
+    return true;
+}
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        if (current->tx_length < MOCK_SPI_MAX_LENGTH) {
+            current->tx[current->tx_length] = data[i];
+        }
+        current->tx_length++;
+    }
+    return mock_spi_result();
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = mock_spi_rx_value++;
+    }
+    current->rx_length += length;
+    return mock_spi_result();
+}
+
+void spi_stop(void) {
+    if (current != NULL) {
+        current->stopped = true;
+        current          = NULL;
+    }
+}
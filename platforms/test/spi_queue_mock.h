@@ -0,0 +1,34 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include "spi_master.h"
+
+#define MOCK_SPI_MAX_TRANSACTIONS 64
+#define MOCK_SPI_MAX_LENGTH 80
+
+typedef struct {
+    pin_t    cs_pin;
+    uint8_t  mode;
+    uint16_t divisor;
+    uint16_t tx_length; // bytes sent while selected
+    uint8_t  tx[MOCK_SPI_MAX_LENGTH];
+    uint16_t rx_length; // bytes received while selected
+    bool     stopped;
+} mock_spi_transaction_t;
+
+// Transactions issued on the mock bus, from spi_start() to spi_stop(), in order
+extern mock_spi_transaction_t mock_spi_transactions[MOCK_SPI_MAX_TRANSACTIONS];
+extern uint32_t               mock_spi_transaction_count;
+
+// Byte returned for each byte received, incremented after each one
+extern uint8_t mock_spi_rx_value;
+
+// Number of upcoming transmits or receives which fail with SPI_STATUS_ERROR
+extern uint32_t mock_spi_fail_count;
+
+// Number of upcoming starts which fail
+extern uint32_t mock_spi_start_fail_count;
+
+void mock_spi_reset(void);
@@ -0,0 +1,148 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "spi_queue.h"
+#include "spi_queue_mock.h"
+}
+
+struct completion_t {
+    spi_status_t status;
+    uintptr_t    context;
+};
+
+static std::vector<completion_t> completions;
+
+static void record_completion(spi_status_t status, void *context) {
+    completions.push_back({status, (uintptr_t)context});
+}
+
+static const spi_queue_device_t sensor  = {.cs_pin = 1, .lsb_first = false, .mode = 3, .divisor = 8};
+static const spi_queue_device_t display = {.cs_pin = 2, .lsb_first = false, .mode = 0, .divisor = 2};
+
+class SPIQueueTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        spi_queue_wait();
+        mock_spi_reset();
+        completions.clear();
+    }
+};
+
+TEST_F(SPIQueueTest, TransactionsRunInOrderInTheBackground) {
+    const uint8_t header[] = {0x02, 0x00};
+    const uint8_t data[]   = {0x11, 0x22, 0x33};
+    EXPECT_TRUE(spi_queue_transmit(&display, header, sizeof(header), data, sizeof(data), record_completion, (void *)1));
+    EXPECT_TRUE(spi_queue_transmit(&sensor, header, 1, NULL, 0, record_completion, (void *)2));
+
+    // Nothing is sent until the backend gets to it
+    EXPECT_EQ(mock_spi_transaction_count, 0u);
+    EXPECT_FALSE(spi_queue_is_idle());
+
+    spi_queue_process();
+    ASSERT_EQ(mock_spi_transaction_count, 2u);
+    EXPECT_EQ(mock_spi_transactions[0].cs_pin, display.cs_pin);
+    EXPECT_EQ(mock_spi_transactions[0].mode, display.mode);
+    EXPECT_EQ(mock_spi_transactions[0].divisor, display.divisor);
+    ASSERT_EQ(mock_spi_transactions[0].tx_length, 5);
+    EXPECT_EQ(mock_spi_transactions[0].tx[0], 0x02);
+    EXPECT_EQ(mock_spi_transactions[0].tx[2], 0x11);
+    EXPECT_EQ(mock_spi_transactions[0].tx[4], 0x33);
+    EXPECT_TRUE(mock_spi_transactions[0].stopped);
+    EXPECT_EQ(mock_spi_transactions[1].cs_pin, sensor.cs_pin);
+    EXPECT_EQ(mock_spi_transactions[1].mode, sensor.mode);
+    EXPECT_EQ(mock_spi_transactions[1].tx_length, 1);
+    EXPECT_TRUE(mock_spi_transactions[1].stopped);
+
+    // Callbacks are deferred to the task
+    EXPECT_TRUE(completions.empty());
+    spi_queue_task();
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].context, 1u);
+    EXPECT_EQ(completions[0].status, SPI_STATUS_SUCCESS);
+    EXPECT_EQ(completions[1].context, 2u);
+    EXPECT_TRUE(spi_queue_is_idle());
+}
+
+TEST_F(SPIQueueTest, HeaderIsCopiedAndDataIsReadWhenTransferred) {
+    uint8_t header[1] = {0x80};
+    uint8_t data[2]   = {0x01, 0x02};
+    spi_queue_transmit(&display, header, sizeof(header), data, sizeof(data), NULL, NULL);
+    header[0] = 0x00;
+    data[1]   = 0x42;
+
+    spi_queue_process();
+    ASSERT_EQ(mock_spi_transaction_count, 1u);
+    EXPECT_EQ(mock_spi_transactions[0].tx[0], 0x80);
+    EXPECT_EQ(mock_spi_transactions[0].tx[2], 0x42);
+}
+
+TEST_F(SPIQueueTest, ReceiveFillsBufferAfterHeader) {
+    const uint8_t header[] = {0x50};
+    uint8_t       data[4]  = {0};
+    mock_spi_rx_value      = 0xA0;
+    spi_queue_receive(&sensor, header, sizeof(header), data, sizeof(data), record_completion, NULL);
+    spi_queue_wait();
+
+    ASSERT_EQ(mock_spi_transaction_count, 1u);
+    EXPECT_EQ(mock_spi_transactions[0].tx_length, 1);
+    EXPECT_EQ(mock_spi_transactions[0].rx_length, 4);
+    EXPECT_EQ(data[0], 0xA0);
+    EXPECT_EQ(data[3], 0xA3);
+    ASSERT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions[0].status, SPI_STATUS_SUCCESS);
+}
+
+TEST_F(SPIQueueTest, FailedHeaderSkipsDataAndDeselects) {
+    const uint8_t header[] = {0x02, 0x00};
+    const uint8_t data[]   = {0x11, 0x22};
+    mock_spi_fail_count    = 1;
+    spi_queue_transmit(&display, header, sizeof(header), data, sizeof(data), record_completion, NULL);
+    spi_queue_transmit(&display, header, sizeof(header), data, sizeof(data), record_completion, NULL);
+    spi_queue_wait();
+
+    ASSERT_EQ(mock_spi_transaction_count, 2u);
+    EXPECT_EQ(mock_spi_transactions[0].tx_length, 2);
+    EXPECT_TRUE(mock_spi_transactions[0].stopped);
+    EXPECT_EQ(mock_spi_transactions[1].tx_length, 4);
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].status, SPI_STATUS_ERROR);
+    EXPECT_EQ(completions[1].status, SPI_STATUS_SUCCESS);
+}
+
+TEST_F(SPIQueueTest, FailedStartIsReported) {
+    mock_spi_start_fail_count = 1;
+    spi_queue_transmit(&sensor, NULL, 0, NULL, 0, record_completion, NULL);
+    spi_queue_wait();
+
+    EXPECT_EQ(mock_spi_transaction_count, 0u);
+    ASSERT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions[0].status, SPI_STATUS_ERROR);
+}
+
+TEST_F(SPIQueueTest, FullQueueWaitsForSpace) {
+    uint8_t header[1];
+    for (int i = 0; i < SPI_QUEUE_SIZE; i++) {
+        header[0] = i;
+        spi_queue_transmit(&sensor, header, 1, NULL, 0, NULL, NULL);
+    }
+    EXPECT_EQ(mock_spi_transaction_count, 0u);
+
+    header[0] = SPI_QUEUE_SIZE;
+    spi_queue_transmit(&sensor, header, 1, NULL, 0, NULL, NULL);
+    EXPECT_EQ(mock_spi_transaction_count, (uint32_t)SPI_QUEUE_SIZE);
+
+    spi_queue_wait();
+    ASSERT_EQ(mock_spi_transaction_count, (uint32_t)SPI_QUEUE_SIZE + 1);
+    for (int i = 0; i <= SPI_QUEUE_SIZE; i++) {
+        EXPECT_EQ(mock_spi_transactions[i].tx[0], i);
+    }
+}
+
+TEST_F(SPIQueueTest, OversizedHeaderIsRejected) {
+    static uint8_t header[SPI_QUEUE_MAX_HEADER_LENGTH + 1];
+    EXPECT_FALSE(spi_queue_transmit(&sensor, header, sizeof(header), NULL, 0, NULL, NULL));
+    EXPECT_TRUE(spi_queue_is_idle());
+}
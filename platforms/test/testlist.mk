@@ -1 +1 @@
-TEST_LIST += eeprom_legacy_emulated_flash_tiny eeprom_legacy_emulated_flash_large
+TEST_LIST += eeprom_legacy_emulated_flash_tiny eeprom_legacy_emulated_flash_large eeprom_page_cache ws2812_encode i2c_queue spi_queue
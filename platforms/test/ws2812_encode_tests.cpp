@@ -0,0 +1,95 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <chrono>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ws2812_encode.h"
+}
+
+// Reference implementation, as previously used by the SPI driver
+static uint8_t reference_spi_eq(uint8_t data, int pos) {
+    uint8_t eq = 0;
+    if (data & (1 << (2 * (3 - pos))))
+        eq = 0b1110;
+    else
+        eq = 0b1000;
+    if (data & (2 << (2 * (3 - pos))))
+        eq += 0b11100000;
+    else
+        eq += 0b10000000;
+    return eq;
+}
+
+class Ws2812EncodeTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        ws2812_encode_invalidate();
+    }
+};
+
+TEST_F(Ws2812EncodeTest, ChannelsInWireOrder) {
+    rgb_led_t led = {};
+    led.r         = 0x11;
+    led.g         = 0x22;
+    led.b         = 0x33;
+
+    uint8_t channels[WS2812_CHANNELS];
+    ws2812_encode_channels(&led, channels);
+    EXPECT_EQ(channels[0], 0x22);
+    EXPECT_EQ(channels[1], 0x11);
+    EXPECT_EQ(channels[2], 0x33);
+}
+
+TEST_F(Ws2812EncodeTest, SpiMatchesReferenceForAllBytes) {
+    for (int value = 0; value < 256; value++) {
+        uint8_t data = value;
+        uint8_t out[WS2812_SPI_BYTES_PER_CHANNEL];
+        ws2812_encode_spi(&data, 1, out);
+        for (int pos = 0; pos < WS2812_SPI_BYTES_PER_CHANNEL; pos++) {
+            EXPECT_EQ(out[pos], reference_spi_eq(data, pos)) << "value " << value << " pos " << pos;
+        }
+    }
+}
+
+TEST_F(Ws2812EncodeTest, UnchangedLedIsSkipped) {
+    rgb_led_t led = {};
+    led.r         = 0x80;
+
+    uint8_t channels[WS2812_CHANNELS];
+    EXPECT_TRUE(ws2812_encode_led_changed(0, &led, channels));
+    EXPECT_FALSE(ws2812_encode_led_changed(0, &led, channels));
+    // Other LEDs are tracked separately
+    EXPECT_TRUE(ws2812_encode_led_changed(1, &led, channels));
+
+    led.b = 0x01;
+    EXPECT_TRUE(ws2812_encode_led_changed(0, &led, channels));
+    EXPECT_EQ(channels[2], 0x01);
+
+    ws2812_encode_invalidate();
+    EXPECT_TRUE(ws2812_encode_led_changed(0, &led, channels));
+}
+
+TEST_F(Ws2812EncodeTest, SpiThroughput) {
+    static rgb_led_t leds[WS2812_LED_COUNT];
+    static uint8_t   txbuf[WS2812_LED_COUNT * WS2812_CHANNELS * WS2812_SPI_BYTES_PER_CHANNEL];
+    const int        frames = 1000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < WS2812_LED_COUNT; i++) {
+            leds[i].r = frame + i;
+            leds[i].g = frame * 3 + i;
+            leds[i].b = frame * 7 + i;
+
+            uint8_t channels[WS2812_CHANNELS];
+            if (ws2812_encode_led_changed(i, &leds[i], channels)) {
+                ws2812_encode_spi(channels, WS2812_CHANNELS, &txbuf[i * WS2812_CHANNELS * WS2812_SPI_BYTES_PER_CHANNEL]);
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "[          ] " << WS2812_LED_COUNT << " LEDs: " << elapsed / frames << " ns/frame, " << elapsed / (frames * WS2812_LED_COUNT) << " ns/LED" << std::endl;
+    EXPECT_EQ(txbuf[0], reference_spi_eq(leds[0].g, 0));
+}
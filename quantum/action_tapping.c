@@ -1,10 +1,12 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "keycode.h"
+#include "matrix.h"
 #include "timer.h"
 
 #ifndef NO_ACTION_TAPPING
@@ -20,8 +22,12 @@
 #    else
 #        define IS_TAPPING_RECORD(r) (KEYEQ(tapping_key.event.key, (r->event.key)) && tapping_key.keycode == r->keycode)
 #    endif
-#    define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < GET_TAPPING_TERM(get_record_keycode(&tapping_key, false), &tapping_key))
-#    define WITHIN_QUICK_TAP_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < GET_QUICK_TAP_TERM(get_record_keycode(&tapping_key, false), &tapping_key))
+#    define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < tapping_policy.tapping_term)
+#    define WITHIN_QUICK_TAP_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < tapping_policy.quick_tap_term)
+#    define WAITING_BUFFER_NEXT(i) (((i) + 1) % WAITING_BUFFER_SIZE)
+#    define IS_MATRIX_KEY(key) ((key).row < MATRIX_ROWS && (key).col < MATRIX_COLS)
+
+_Static_assert(WAITING_BUFFER_SIZE >= 2 && WAITING_BUFFER_SIZE <= 255, "WAITING_BUFFER_SIZE must be between 2 and 255");
 
 #    ifdef DYNAMIC_TAPPING_TERM_ENABLE
 uint16_t g_tapping_term = TAPPING_TERM;
@@ -59,14 +65,48 @@ __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyreco
 #        include "process_auto_shift.h"
 #    endif
 
-static keyrecord_t tapping_key                         = {};
-static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t     waiting_buffer_head                 = 0;
-static uint8_t     waiting_buffer_tail                 = 0;
+/* Tapping settings of tapping_key, resolved by tapping_key_set() whenever a tap
+ * key is pressed or tapped again. The per-key callbacks and keymap lookup are
+ * then not repeated for every tick and key event while the key is pending.
+ */
+typedef struct {
+    uint16_t keycode;
+    uint16_t tapping_term;
+    uint16_t quick_tap_term;
+#    ifdef PERMISSIVE_HOLD_PER_KEY
+    bool permissive_hold;
+#    endif
+#    ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+    bool hold_on_other_key_press;
+#    endif
+#    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT) && defined(RETRO_TAPPING_PER_KEY)
+    bool retro_tapping;
+#    endif
+} tapping_policy_t;
+
+static keyrecord_t      tapping_key                         = {};
+static tapping_policy_t tapping_policy                      = {};
+static keyrecord_t      waiting_buffer[WAITING_BUFFER_SIZE] = {};
+static uint8_t          waiting_buffer_head                 = 0;
+static uint8_t          waiting_buffer_tail                 = 0;
+
+/* Summary of the waiting buffer, kept up to date as events are queued and
+ * dequeued so that the queries made for every event need not scan it.
+ * Events from outside the matrix, such as combos and encoders, are only
+ * counted, and fall back to a scan.
+ */
+static uint8_t      waiting_buffer_presses              = 0;
+static uint8_t      waiting_buffer_offmatrix            = 0;
+static matrix_row_t waiting_buffer_keys[2][MATRIX_ROWS] = {}; // matrix keys with a queued release [0] or press [1]
 
+static void tapping_key_set(const keyrecord_t *record);
 static bool process_tapping(keyrecord_t *record);
+static void waiting_buffer_process(void);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
 static void waiting_buffer_clear(void);
+static bool waiting_buffer_find(keypos_t key, bool pressed, uint8_t *index);
+static bool waiting_buffer_contains(keypos_t key, bool pressed);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -84,7 +124,16 @@ void action_tapping_process(keyrecord_t record) {
             debug_record(record);
             ac_dprintf("\n");
         }
-    } else {
+    } else if (!waiting_buffer_enq(record)) {
+        // A tap key held while this many other events arrive is being used as a
+        // modifier or layer key, so settle it as held to drain the buffer
+        if (tapping_key.event.pressed && tapping_key.tap.count == 0) {
+            ac_dprintf("Tapping: End. No tap. Waiting buffer full\n");
+            process_record(&tapping_key);
+            tapping_key = (keyrecord_t){0};
+            debug_tapping_key();
+            waiting_buffer_process();
+        }
         if (!waiting_buffer_enq(record)) {
             // clear all in case of overflow.
             ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
@@ -98,15 +147,7 @@ void action_tapping_process(keyrecord_t record) {
     if (IS_EVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         ac_dprintf("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
-            debug_record(waiting_buffer[waiting_buffer_tail]);
-            ac_dprintf("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (IS_EVENT(record.event)) {
         ac_dprintf("\n");
     }
@@ -116,11 +157,11 @@ void action_tapping_process(keyrecord_t record) {
  * readable. The conditional definition of tapping_keycode and all the
  * conditional uses of it are hidden inside macros named TAP_...
  */
-#    define TAP_DEFINE_KEYCODE const uint16_t tapping_keycode = get_record_keycode(&tapping_key, false)
+#    define TAP_DEFINE_KEYCODE const uint16_t tapping_keycode = tapping_policy.keycode
 
 #    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
 #        ifdef RETRO_TAPPING_PER_KEY
-#            define TAP_GET_RETRO_TAPPING(keyp) get_auto_shifted_key(tapping_keycode, keyp) && get_retro_tapping(tapping_keycode, &tapping_key)
+#            define TAP_GET_RETRO_TAPPING(keyp) get_auto_shifted_key(tapping_keycode, keyp) && tapping_policy.retro_tapping
 #        else
 #            define TAP_GET_RETRO_TAPPING(keyp) get_auto_shifted_key(tapping_keycode, keyp)
 #        endif
@@ -142,7 +183,7 @@ void action_tapping_process(keyrecord_t record) {
 #    endif
 
 #    ifdef PERMISSIVE_HOLD_PER_KEY
-#        define TAP_GET_PERMISSIVE_HOLD get_permissive_hold(tapping_keycode, &tapping_key)
+#        define TAP_GET_PERMISSIVE_HOLD tapping_policy.permissive_hold
 #    elif defined(PERMISSIVE_HOLD)
 #        define TAP_GET_PERMISSIVE_HOLD true
 #    else
@@ -150,13 +191,34 @@ void action_tapping_process(keyrecord_t record) {
 #    endif
 
 #    ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
-#        define TAP_GET_HOLD_ON_OTHER_KEY_PRESS get_hold_on_other_key_press(tapping_keycode, &tapping_key)
+#        define TAP_GET_HOLD_ON_OTHER_KEY_PRESS tapping_policy.hold_on_other_key_press
 #    elif defined(HOLD_ON_OTHER_KEY_PRESS)
 #        define TAP_GET_HOLD_ON_OTHER_KEY_PRESS true
 #    else
 #        define TAP_GET_HOLD_ON_OTHER_KEY_PRESS false
 #    endif
 
+/** \brief Sets the tapping key, and resolves its tapping settings
+ *
+ * The keycode comes from the source layer cache, so it is fixed for as long as
+ * the key is held.
+ */
+static void tapping_key_set(const keyrecord_t *record) {
+    tapping_key                   = *record;
+    tapping_policy.keycode        = get_record_keycode(&tapping_key, false);
+    tapping_policy.tapping_term   = GET_TAPPING_TERM(tapping_policy.keycode, &tapping_key);
+    tapping_policy.quick_tap_term = GET_QUICK_TAP_TERM(tapping_policy.keycode, &tapping_key);
+#    ifdef PERMISSIVE_HOLD_PER_KEY
+    tapping_policy.permissive_hold = get_permissive_hold(tapping_policy.keycode, &tapping_key);
+#    endif
+#    ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+    tapping_policy.hold_on_other_key_press = get_hold_on_other_key_press(tapping_policy.keycode, &tapping_key);
+#    endif
+#    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT) && defined(RETRO_TAPPING_PER_KEY)
+    tapping_policy.retro_tapping = get_retro_tapping(tapping_policy.keycode, &tapping_key);
+#    endif
+}
+
 /** \brief Tapping
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
@@ -175,7 +237,7 @@ bool process_tapping(keyrecord_t *keyp) {
             // the currently pressed key is a tapping key, therefore transition
             // into the "pressed" tapping key state
             ac_dprintf("Tapping: Start(Press tap key).\n");
-            tapping_key = *keyp;
+            tapping_key_set(keyp);
             process_record_tap_hint(&tapping_key);
             waiting_buffer_scan_tap();
             debug_tapping_key();
@@ -188,7 +250,7 @@ bool process_tapping(keyrecord_t *keyp) {
         return true;
     }
 
-#    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
+#    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
     TAP_DEFINE_KEYCODE;
 #    endif
 
@@ -296,7 +358,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     ac_dprintf("Tapping: Tap release(%u)\n", tapping_key.tap.count);
                     keyp->tap = tapping_key.tap;
                     process_record(keyp);
-                    tapping_key = *keyp;
+                    tapping_key_set(keyp);
                     debug_tapping_key();
                     return true;
                 } else if (is_tap_record(keyp) && event.pressed) {
@@ -316,7 +378,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     } else {
                         ac_dprintf("Tapping: Start while last tap(1).\n");
                     }
-                    tapping_key = *keyp;
+                    tapping_key_set(keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -367,7 +429,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     } else {
                         ac_dprintf("Tapping: Start while last timeout tap(1).\n");
                     }
-                    tapping_key = *keyp;
+                    tapping_key_set(keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -394,17 +456,17 @@ bool process_tapping(keyrecord_t *keyp) {
                         if (keyp->tap.count < 15) keyp->tap.count += 1;
                         ac_dprintf("Tapping: Tap press(%u)\n", keyp->tap.count);
                         process_record(keyp);
-                        tapping_key = *keyp;
+                        tapping_key_set(keyp);
                         debug_tapping_key();
                         return true;
                     }
                     // FIX: start new tap again
-                    tapping_key = *keyp;
+                    tapping_key_set(keyp);
                     return true;
                 } else if (is_tap_record(keyp)) {
                     // Sequential tap can be interfered with other tap key.
                     ac_dprintf("Tapping: Start with interfering other tap.\n");
-                    tapping_key = *keyp;
+                    tapping_key_set(keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -432,6 +494,22 @@ bool process_tapping(keyrecord_t *keyp) {
     }
 }
 
+/** \brief Waiting buffer process
+ *
+ * Passes queued events to process_tapping() in order, until one has to keep waiting.
+ */
+void waiting_buffer_process(void) {
+    while (waiting_buffer_tail != waiting_buffer_head) {
+        if (!process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            break;
+        }
+        ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
+        debug_record(waiting_buffer[waiting_buffer_tail]);
+        ac_dprintf("\n\n");
+        waiting_buffer_deq();
+    }
+}
+
 /** \brief Waiting buffer enq
  *
  * FIXME: Needs docs
@@ -441,50 +519,99 @@ bool waiting_buffer_enq(keyrecord_t record) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
         ac_dprintf("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head                 = WAITING_BUFFER_NEXT(waiting_buffer_head);
+
+    if (record.event.pressed) {
+        waiting_buffer_presses++;
+    }
+    if (IS_MATRIX_KEY(record.event.key)) {
+        waiting_buffer_keys[record.event.pressed][record.event.key.row] |= (matrix_row_t)1 << record.event.key.col;
+    } else {
+        waiting_buffer_offmatrix++;
+    }
 
     ac_dprintf("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Removes the oldest event, which has been processed.
+ */
+void waiting_buffer_deq(void) {
+    keyevent_t event    = waiting_buffer[waiting_buffer_tail].event;
+    waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail);
+
+    if (event.pressed) {
+        waiting_buffer_presses--;
+    }
+    if (!IS_MATRIX_KEY(event.key)) {
+        waiting_buffer_offmatrix--;
+    } else if (!waiting_buffer_find(event.key, event.pressed, NULL)) {
+        waiting_buffer_keys[event.pressed][event.key.row] &= ~((matrix_row_t)1 << event.key.col);
+    }
+}
+
 /** \brief Waiting buffer clear
  *
  * FIXME: Needs docs
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head      = 0;
+    waiting_buffer_tail      = 0;
+    waiting_buffer_presses   = 0;
+    waiting_buffer_offmatrix = 0;
+    memset(waiting_buffer_keys, 0, sizeof(waiting_buffer_keys));
 }
 
-/** \brief Waiting buffer typed
+/** \brief Waiting buffer find
  *
- * FIXME: Needs docs
+ * Scans for the oldest queued event of `key` being pressed or released, and stores its position in `index`.
  */
-bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
+bool waiting_buffer_find(keypos_t key, bool pressed, uint8_t *index) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
+        if (KEYEQ(key, waiting_buffer[i].event.key) && pressed == waiting_buffer[i].event.pressed) {
+            if (index) {
+                *index = i;
+            }
             return true;
         }
     }
     return false;
 }
 
+/** \brief Waiting buffer contains
+ *
+ * Returns whether an event of `key` being pressed or released is queued.
+ */
+bool waiting_buffer_contains(keypos_t key, bool pressed) {
+    if (IS_MATRIX_KEY(key)) {
+        return waiting_buffer_keys[pressed][key.row] & ((matrix_row_t)1 << key.col);
+    }
+    return waiting_buffer_offmatrix && waiting_buffer_find(key, pressed, NULL);
+}
+
+/** \brief Waiting buffer typed
+ *
+ * Returns whether the opposite of `event` is queued, i.e. the key was pressed or released while waiting.
+ */
+bool waiting_buffer_typed(keyevent_t event) {
+    return waiting_buffer_contains(event.key, !event.pressed);
+}
+
 /** \brief Waiting buffer has anykey pressed
  *
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_presses > 0;
 }
 
 /** \brief Scan buffer for tapping
@@ -495,14 +622,15 @@ void waiting_buffer_scan_tap(void) {
     // early return if:
     // - tapping already is settled
     // - invalid state: tapping_key released && tap.count == 0
-    if ((tapping_key.tap.count > 0) || !tapping_key.event.pressed) {
+    // - the tapping key has not been released since
+    if ((tapping_key.tap.count > 0) || !tapping_key.event.pressed || !waiting_buffer_contains(tapping_key.event.key, false)) {
         return;
     }
 
 #    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
     TAP_DEFINE_KEYCODE;
 #    endif
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         keyrecord_t *candidate = &waiting_buffer[i];
         // clang-format off
         if (IS_EVENT(candidate->event) && KEYEQ(candidate->event.key, tapping_key.event.key) && !candidate->event.pressed && (
@@ -536,7 +664,7 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     ac_dprintf("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         ac_dprintf("[%u]=", i);
         debug_record(waiting_buffer[i]);
         ac_dprintf(" ");
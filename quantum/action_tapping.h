@@ -32,7 +32,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* number of key events that can wait on an unsettled tapping key, plus one */
+#ifndef WAITING_BUFFER_SIZE
+#    ifdef __AVR__
+#        define WAITING_BUFFER_SIZE 8
+#    else
+#        define WAITING_BUFFER_SIZE 16
+#    endif
+#endif
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
@@ -136,7 +136,7 @@ void audio_init(void) {
 #endif // EEPROM settings
 
     for (uint8_t i = 0; i < AUDIO_TONE_STACKSIZE; i++) {
-        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .pitch_q16 = 0, .duration = 0};
     }
 
     if (!audio_initialized) {
@@ -205,7 +205,7 @@ void audio_stop_all(void) {
     melody_current_note_duration = 0;
 
     for (uint8_t i = 0; i < AUDIO_TONE_STACKSIZE; i++) {
-        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .pitch_q16 = 0, .duration = 0};
     }
 
     audio_driver_stopped = true;
@@ -224,10 +224,10 @@ void audio_stop_tone(float pitch) {
         for (int i = AUDIO_TONE_STACKSIZE - 1; i >= 0; i--) {
             found = (tones[i].pitch == pitch);
             if (found) {
-                tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+                tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .pitch_q16 = 0, .duration = 0};
                 for (int j = i; (j < AUDIO_TONE_STACKSIZE - 1); j++) {
                     tones[j]     = tones[j + 1];
-                    tones[j + 1] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+                    tones[j + 1] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .pitch_q16 = 0, .duration = 0};
                 }
                 break;
             }
@@ -273,7 +273,7 @@ void audio_play_note(float pitch, uint16_t duration) {
         if (found) {
             for (int j = i; (j < active_tones - 1); j++) {
                 tones[j]     = tones[j + 1];
-                tones[j + 1] = (musical_tone_t){.time_started = timer_read(), .pitch = pitch, .duration = duration};
+                tones[j + 1] = (musical_tone_t){.time_started = timer_read(), .pitch = pitch, .pitch_q16 = audio_freq_to_q16(pitch), .duration = duration};
             }
             return; // since this frequency played already, the hardware was already started
         }
@@ -290,7 +290,7 @@ void audio_play_note(float pitch, uint16_t duration) {
     }
     state_changed           = true;
     playing_note            = true;
-    tones[active_tones - 1] = (musical_tone_t){.time_started = timer_read(), .pitch = pitch, .duration = duration};
+    tones[active_tones - 1] = (musical_tone_t){.time_started = timer_read(), .pitch = pitch, .pitch_q16 = audio_freq_to_q16(pitch), .duration = duration};
 
     // TODO: needs to be handled per note/tone -> use its timestamp instead?
     voices_timer = timer_read(); // reset to zero, for the effects added by voices.c
@@ -380,8 +380,12 @@ float audio_get_frequency(uint8_t tone_index) {
 }
 
 float audio_get_processed_frequency(uint8_t tone_index) {
+    return AUDIO_FREQ_Q16_TO_FLOAT(audio_get_processed_frequency_q16(tone_index));
+}
+
+audio_freq_q16_t audio_get_processed_frequency_q16(uint8_t tone_index) {
     if (tone_index >= active_tones) {
-        return 0.0f;
+        return 0;
     }
 
     int8_t index = active_tones - tone_index - 1;
@@ -393,11 +397,11 @@ float audio_get_processed_frequency(uint8_t tone_index) {
         index += active_tones;
 #endif
 
-    if (tones[index].pitch <= 0.0f) {
-        return 0.0f;
+    if (tones[index].pitch_q16 == 0) {
+        return 0;
     }
 
-    return voice_envelope(tones[index].pitch);
+    return voice_envelope_q16(tones[index].pitch_q16);
 }
 
 bool audio_update_state(void) {
@@ -45,9 +45,10 @@ _Static_assert(sizeof(audio_config_t) == sizeof(uint8_t), "Audio EECONFIG out of
  * "A musical tone is characterized by its duration, pitch, intensity (or loudness), and timbre (or quality)"
  */
 typedef struct {
-    uint16_t time_started; // timestamp the tone/note was started, system time runs with 1ms resolution -> 16bit timer overflows every ~64 seconds, long enough under normal circumstances; but might be too soon for long-duration notes when the note_tempo is set to a very low value
-    float    pitch;        // aka frequency, in Hz
-    uint16_t duration;     // in ms, converted from the musical_notes.h unit which has 64parts to a beat, factoring in the current tempo in beats-per-minute
+    uint16_t         time_started; // timestamp the tone/note was started, system time runs with 1ms resolution -> 16bit timer overflows every ~64 seconds, long enough under normal circumstances; but might be too soon for long-duration notes when the note_tempo is set to a very low value
+    float            pitch;        // aka frequency, in Hz
+    audio_freq_q16_t pitch_q16;    // pitch as fixed point, converted once when the tone is started
+    uint16_t         duration;     // in ms, converted from the musical_notes.h unit which has 64parts to a beat, factoring in the current tempo in beats-per-minute
     // float intensity;    // aka volume [0,1] TODO: not used at the moment; pwm drivers can't handle it
     // uint8_t timbre;     // range: [0,100] TODO: this currently kept track of globally, should we do this per tone instead?
 } musical_tone_t;
@@ -248,6 +249,17 @@ float audio_get_frequency(uint8_t tone_index);
  */
 float audio_get_processed_frequency(uint8_t tone_index);
 
+/**
+ * @brief calculate and return the frequency for the requested tone, as Q16.16 fixed point
+ * @details as audio_get_processed_frequency, but without any float arithmetic;
+ *          for drivers that update their output while tones are playing
+ * @param[in] tone_index, ranging from 0 to number_of_active_tones-1, with the
+ *            first being the most recent and each increment yielding the next
+ *            older one
+ * @return a positive frequency, in Hz * 65536; or zero if the tone is a pause
+ */
+audio_freq_q16_t audio_get_processed_frequency_q16(uint8_t tone_index);
+
 /**
  * @brief   update audio internal state: currently playing and active tones,...
  * @details This function is intended to be called by the audio-hardware
@@ -0,0 +1,38 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "audio.h"
+
+/**
+ * Rate at which rendered samples reach the output, in Hz.
+ *
+ * The DAC timer runs at 3*AUDIO_DAC_SAMPLE_RATE and the DAC callback is called twice per conversion,
+ * which works out to samples being consumed at 3/2 of the nominal AUDIO_DAC_SAMPLE_RATE.
+ */
+#ifndef AUDIO_SYNTH_OUTPUT_RATE
+#    define AUDIO_SYNTH_OUTPUT_RATE (AUDIO_DAC_SAMPLE_RATE * 3 / 2)
+#endif
+
+/**
+ * @brief Reset the oscillators, and fade in on the next zero crossing of the output.
+ */
+void audio_synth_start(void);
+
+/**
+ * @brief Fade out on the next zero crossing of the output.
+ */
+void audio_synth_stop(void);
+
+/**
+ * @brief Fill one block of samples, then advance the audio state by one tick.
+ *
+ * @param[out] samples buffer to fill, with values between 0 and AUDIO_DAC_SAMPLE_MAX
+ * @param[in] count number of samples in one block, AUDIO_DAC_BUFFER_SIZE / 2 on hardware
+ * @return true once the output has settled at AUDIO_DAC_OFF_VALUE after a stop, and the sample clock can be halted
+ */
+bool audio_synth_render(uint16_t *samples, size_t count);
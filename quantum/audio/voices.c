@@ -47,16 +47,32 @@ void voice_deiterate(void) {
 }
 
 #ifdef AUDIO_VOICES
-float mod(float a, int b) {
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
+// vibrato_rate and vibrato_strength, converted to fixed point when either of them changes
+static bool             vibrato_dirty = true;
+static bool             vibrato_audible;
+static uint32_t         vibrato_step_q16;                       // LUT positions per ms
+static audio_freq_q16_t vibrato_factor_q16[VIBRATO_LUT_LENGTH]; // vibrato_lut, raised to vibrato_strength
+
+static void voice_update_vibrato(void) {
+    vibrato_audible  = vibrato_strength > 0;
+    vibrato_step_q16 = (uint32_t)(AUDIO_FREQ_Q16_ONE / (100 * vibrato_rate));
+    for (uint8_t i = 0; i < VIBRATO_LUT_LENGTH; i++) {
+        vibrato_factor_q16[i] = (audio_freq_q16_t)(pow(vibrato_lut[i], vibrato_strength) * AUDIO_FREQ_Q16_ONE + 0.5f);
+    }
+    vibrato_dirty = false;
 }
 
 // Effect: 'vibrate' a given target frequency slightly above/below its initial value
-float voice_add_vibrato(float average_freq) {
-    float vibrato_counter = mod(timer_read() / (100 * vibrato_rate), VIBRATO_LUT_LENGTH);
+static audio_freq_q16_t voice_add_vibrato(audio_freq_q16_t average_freq) {
+    if (vibrato_dirty) {
+        voice_update_vibrato();
+    }
+    if (!vibrato_audible) {
+        return average_freq;
+    }
+    uint8_t vibrato_counter = (((uint64_t)timer_read() * vibrato_step_q16) >> 16) % VIBRATO_LUT_LENGTH;
 
-    return average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
+    return ((uint64_t)average_freq * vibrato_factor_q16[vibrato_counter]) >> 16;
 }
 
 // Effect: 'slides' the 'frequency' from the starting-point, to the target frequency
@@ -71,7 +87,7 @@ float voice_add_glissando(float from_freq, float to_freq) {
 }
 #endif
 
-float voice_envelope(float frequency) {
+audio_freq_q16_t voice_envelope_q16(audio_freq_q16_t frequency) {
     // envelope_index ranges from 0 to 0xFFFF, which is preserved at 880.0 Hz
 //    __attribute__((unused)) uint16_t compensated_index = (uint16_t)((float)envelope_index * (880.0 / frequency));
 #ifdef AUDIO_VOICES
@@ -128,10 +144,10 @@ float voice_envelope(float frequency) {
             // }
             // frequency = (rand() % (int)(frequency * 1.2 - frequency)) + (frequency * 0.8);
 
-            if (frequency < 80.0) {
-            } else if (frequency < 160.0) {
+            if (frequency < 80 * AUDIO_FREQ_Q16_ONE) {
+            } else if (frequency < 160 * AUDIO_FREQ_Q16_ONE) {
                 // Bass drum: 60 - 100 Hz
-                frequency = (rand() % (int)(40)) + 60;
+                frequency = ((rand() % 40) + 60) * AUDIO_FREQ_Q16_ONE;
                 switch (envelope_index) {
                     case 0 ... 10:
                         note_timbre = 50;
@@ -144,9 +160,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 320.0) {
+            } else if (frequency < 320 * AUDIO_FREQ_Q16_ONE) {
                 // Snare drum: 1 - 2 KHz
-                frequency = (rand() % (int)(1000)) + 1000;
+                frequency = ((rand() % 1000) + 1000) * AUDIO_FREQ_Q16_ONE;
                 switch (envelope_index) {
                     case 0 ... 5:
                         note_timbre = 50;
@@ -159,9 +175,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 640.0) {
+            } else if (frequency < 640 * AUDIO_FREQ_Q16_ONE) {
                 // Closed Hi-hat: 3 - 5 KHz
-                frequency = (rand() % (int)(2000)) + 3000;
+                frequency = ((rand() % 2000) + 3000) * AUDIO_FREQ_Q16_ONE;
                 switch (envelope_index) {
                     case 0 ... 15:
                         note_timbre = 50;
@@ -174,9 +190,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 1280.0) {
+            } else if (frequency < 1280 * AUDIO_FREQ_Q16_ONE) {
                 // Open Hi-hat: 3 - 5 KHz
-                frequency = (rand() % (int)(2000)) + 3000;
+                frequency = ((rand() % 2000) + 3000) * AUDIO_FREQ_Q16_ONE;
                 switch (envelope_index) {
                     case 0 ... 35:
                         note_timbre = 50;
@@ -204,7 +220,8 @@ float voice_envelope(float frequency) {
                     break;
 
                 case 20 ... 200:
-                    note_timbre = 12 - (uint8_t)(pow(((float)compensated_index - 20) / (200 - 20), 2) * 12.5);
+                    // 12.5 * ((compensated_index - 20) / (200 - 20))^2
+                    note_timbre = 12 - (uint8_t)((uint32_t)(compensated_index - 20) * (compensated_index - 20) * 25 / (2 * (200 - 20) * (200 - 20)));
                     break;
 
                 default:
@@ -241,18 +258,18 @@ float voice_envelope(float frequency) {
             switch (compensated_index) {
                 default:
 #    define OCS_SPEED 10
-#    define OCS_AMP .25
+#    define OCS_AMP 25 // in percent
                     // sine wave is slow
-                    // note_timbre = (sin((float)compensated_index/10000*OCS_SPEED) * OCS_AMP / 2) + .5;
+                    // note_timbre = (sin((float)compensated_index/10000*OCS_SPEED) * OCS_AMP / 2) + 50;
                     // triangle wave is a bit faster
-                    note_timbre = (uint8_t)abs((compensated_index * OCS_SPEED % 3000) - 1500) * (OCS_AMP / 1500) + (1 - OCS_AMP) / 2;
+                    note_timbre = abs((compensated_index * OCS_SPEED % 3000) - 1500) * OCS_AMP / 1500 + (100 - OCS_AMP) / 2;
                     break;
             }
             break;
 
         case duty_octave_down:
             glissando   = true;
-            note_timbre = (uint8_t)(100 * (envelope_index % 2) * .125 + .375 * 2);
+            note_timbre = (uint8_t)((100 * (envelope_index % 2) * 125 + 375 * 2) / 1000);
             if ((envelope_index % 4) == 0) note_timbre = 50;
             if ((envelope_index % 8) == 0) note_timbre = 0;
             break;
@@ -266,7 +283,7 @@ float voice_envelope(float frequency) {
                     break;
                 default:
                     // TODO: merge/replace with voice_add_vibrato above
-                    frequency = frequency * vibrato_lut[(int)fmod((((float)compensated_index - (VOICE_VIBRATO_DELAY + 1)) / 1000 * VOICE_VIBRATO_SPEED), VIBRATO_LUT_LENGTH)];
+                    frequency = ((uint64_t)frequency * vibrato_lut_q16[(compensated_index - (VOICE_VIBRATO_DELAY + 1)) * VOICE_VIBRATO_SPEED / 1000 % VIBRATO_LUT_LENGTH]) >> 16;
                     break;
             }
             break;
@@ -318,7 +335,7 @@ float voice_envelope(float frequency) {
     }
 
 #ifdef AUDIO_VOICES
-    if (vibrato && (vibrato_strength > 0)) {
+    if (vibrato) {
         frequency = voice_add_vibrato(frequency);
     }
 
@@ -331,25 +348,47 @@ float voice_envelope(float frequency) {
     return frequency;
 }
 
+float voice_envelope(float frequency) {
+    return AUDIO_FREQ_Q16_TO_FLOAT(voice_envelope_q16(audio_freq_to_q16(frequency)));
+}
+
 // Vibrato functions
 
 void voice_set_vibrato_rate(float rate) {
     vibrato_rate = rate;
+#ifdef AUDIO_VOICES
+    vibrato_dirty = true;
+#endif
 }
 void voice_increase_vibrato_rate(float change) {
     vibrato_rate *= change;
+#ifdef AUDIO_VOICES
+    vibrato_dirty = true;
+#endif
 }
 void voice_decrease_vibrato_rate(float change) {
     vibrato_rate /= change;
+#ifdef AUDIO_VOICES
+    vibrato_dirty = true;
+#endif
 }
 void voice_set_vibrato_strength(float strength) {
     vibrato_strength = strength;
+#ifdef AUDIO_VOICES
+    vibrato_dirty = true;
+#endif
 }
 void voice_increase_vibrato_strength(float change) {
     vibrato_strength *= change;
+#ifdef AUDIO_VOICES
+    vibrato_dirty = true;
+#endif
 }
 void voice_decrease_vibrato_strength(float change) {
     vibrato_strength /= change;
+#ifdef AUDIO_VOICES
+    vibrato_dirty = true;
+#endif
 }
 
 // Timbre functions
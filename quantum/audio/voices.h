@@ -21,7 +21,27 @@
 #include "wait.h"
 #include "luts.h"
 
-float voice_envelope(float frequency);
+/**
+ * @brief frequencies as unsigned Q16.16 fixed point: whole Hz in the upper 16 bits, fractions of a Hz in the lower 16
+ * @note used while tones are playing, so that boards without an FPU need no soft-float arithmetic there
+ */
+typedef uint32_t audio_freq_q16_t;
+
+#define AUDIO_FREQ_Q16_ONE ((audio_freq_q16_t)1 << 16)
+#define AUDIO_FREQ_Q16_TO_FLOAT(q16) ((float)(q16) / AUDIO_FREQ_Q16_ONE)
+
+static inline audio_freq_q16_t audio_freq_to_q16(float frequency) {
+    if (frequency <= 0.0f) {
+        return 0;
+    }
+    if (frequency >= 65535.0f) {
+        return UINT32_MAX;
+    }
+    return (audio_freq_q16_t)(frequency * AUDIO_FREQ_Q16_ONE + 0.5f);
+}
+
+audio_freq_q16_t voice_envelope_q16(audio_freq_q16_t frequency);
+float            voice_envelope(float frequency);
 
 typedef enum {
     default_voice,
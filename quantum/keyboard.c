@@ -108,6 +108,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef EEPROM_DRIVER
 #    include "eeprom_driver.h"
 #endif
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
+#ifdef SPI_QUEUE_ENABLE
+#    include "spi_queue.h"
+#endif
 #if defined(CRC_ENABLE)
 #    include "crc.h"
 #endif
@@ -460,7 +466,7 @@ void keyboard_init(void) {
     haptic_init();
 #endif
 
-#if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
+#if (defined(DEBUG_MATRIX_SCAN_RATE) || defined(DEBUG_USB_SOF_SLACK)) && defined(CONSOLE_ENABLE)
     debug_enable = true;
 #endif
 
@@ -717,5 +723,17 @@ void keyboard_task(void) {
     haptic_task();
 #endif
 
+#ifdef EEPROM_DRIVER
+    eeprom_driver_task();
+#endif
+
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_task();
+#endif
+
+#ifdef SPI_QUEUE_ENABLE
+    spi_queue_task();
+#endif
+
     led_task();
 }
@@ -40,6 +40,26 @@ bool bytequeue_enqueue(byteQueue_t* queue, uint8_t item) {
     }
 }
 
+bool bytequeue_enqueue_bulk(byteQueue_t* queue, const uint8_t* items, byteQueueIndex_t count) {
+    interrupt_setting_t setting = store_and_clear_interrupt();
+    byteQueueIndex_t    used;
+    if (queue->end >= queue->start)
+        used = queue->end - queue->start;
+    else
+        used = (queue->length - queue->start) + queue->end;
+    // all or nothing, one slot is always kept free to tell a full queue from an empty one
+    if (count > queue->length - 1 - used) {
+        restore_interrupt_setting(setting);
+        return false;
+    }
+    for (byteQueueIndex_t i = 0; i < count; i++) {
+        queue->data[queue->end] = items[i];
+        queue->end              = (queue->end + 1) % queue->length;
+    }
+    restore_interrupt_setting(setting);
+    return true;
+}
+
 byteQueueIndex_t bytequeue_length(byteQueue_t* queue) {
     byteQueueIndex_t    len;
     interrupt_setting_t setting = store_and_clear_interrupt();
@@ -59,9 +59,34 @@ void midi_device_init(MidiDevice* device) {
 }
 
 void midi_device_input(MidiDevice* device, uint8_t cnt, uint8_t* input) {
-    uint8_t i;
-    for (i = 0; i < cnt; i++)
-        bytequeue_enqueue(&device->input_queue, input[i]);
+    // a message which does not fit is dropped as a whole, rather than leaving the parser with part of it
+    bytequeue_enqueue_bulk(&device->input_queue, input, cnt);
+}
+
+void midi_device_input_packet(MidiDevice* device, uint8_t cnt, const uint8_t* input) {
+    uint8_t status = input[0];
+
+    if (cnt == 1 && midi_is_realtime(status)) {
+        midi_process_byte(device, status);
+        return;
+    }
+
+    // complete messages outside of sysex, as USB-MIDI packets carry them
+    if (device->input_state != SYSEX_MESSAGE && midi_is_statusbyte(status) && midi_packet_length(status) == cnt) {
+        // keep the status byte, allowing for running status
+        device->input_buffer[0] = status;
+        device->input_count     = 1;
+        device->input_state     = (input_state_t)cnt;
+        midi_input_callbacks(device, cnt, status, cnt > 1 ? input[1] : 0, cnt > 2 ? input[2] : 0);
+        if (cnt == ONE) {
+            device->input_state = IDLE;
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < cnt; i++) {
+        midi_process_byte(device, input[i]);
+    }
 }
 
 void midi_device_set_send_func(MidiDevice* device, midi_var_byte_func_t send_func) {
@@ -81,10 +106,10 @@ void midi_device_process(MidiDevice* device) {
     uint16_t         i;
     // TODO limit number of bytes processed?
     for (i = 0; i < len; i++) {
-        uint8_t val = bytequeue_get(&device->input_queue, 0);
-        midi_process_byte(device, val);
-        bytequeue_remove(&device->input_queue, 1);
+        midi_process_byte(device, bytequeue_get(&device->input_queue, i));
     }
+    // free the processed bytes in one go, rather than masking interrupts for every byte
+    if (len) bytequeue_remove(&device->input_queue, len);
 }
 
 void midi_process_byte(MidiDevice* device, uint8_t input) {
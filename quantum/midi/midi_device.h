@@ -118,6 +118,23 @@ struct _midi_device {
  */
 void midi_device_input(MidiDevice* device, uint8_t cnt, uint8_t* input);
 
+/**
+ * @brief Process one complete message, such as the payload of a USB-MIDI
+ * event packet.  Unlike midi_device_input, the message is parsed and the
+ * callbacks are called straight away, without going through the input
+ * queue, so this must only be called from the same context as
+ * midi_device_process, for instance from the pre input process callback.
+ *
+ * Whole channel, system common and realtime messages are dispatched directly;
+ * sysex data and anything else go through the same byte parser as queued
+ * input, so both paths call the callbacks with the same arguments.
+ *
+ * @param device the midi device to associate the input with
+ * @param cnt the number of bytes in the message, 1 to 3
+ * @param input the bytes of the message
+ */
+void midi_device_input_packet(MidiDevice* device, uint8_t cnt, const uint8_t* input);
+
 /**
  * @brief Set the callback function that will be used for sending output
  * data bytes.  This is only used if you're creating a custom device.
@@ -25,6 +25,19 @@ MidiDevice midi_device;
 #define SYS_COMMON_2 0x20
 #define SYS_COMMON_3 0x30
 
+// Outgoing packets are collected into endpoint sized transfers, sent by flush_midi_packets() once per loop
+#define MIDI_PACKETS_PER_TRANSFER (MIDI_STREAM_EPSIZE / sizeof(MIDI_EventPacket_t))
+
+static MIDI_EventPacket_t send_buffer[MIDI_PACKETS_PER_TRANSFER];
+static uint8_t            send_buffer_count = 0;
+
+void flush_midi_packets(void) {
+    if (send_buffer_count) {
+        send_midi_packets(send_buffer, send_buffer_count);
+        send_buffer_count = 0;
+    }
+}
+
 static void usb_send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
     MIDI_EventPacket_t event;
     event.Data1 = byte0;
@@ -74,32 +87,35 @@ static void usb_send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8
         }
     }
 
-    send_midi_packet(&event);
+    send_buffer[send_buffer_count++] = event;
+    if (send_buffer_count == MIDI_PACKETS_PER_TRANSFER) {
+        flush_midi_packets();
+    }
 }
 
 static void usb_get_midi(MidiDevice* device) {
-    MIDI_EventPacket_t event;
-    while (recv_midi_packet(&event)) {
-        midi_packet_length_t length = midi_packet_length(event.Data1);
-        uint8_t              input[3];
-        input[0] = event.Data1;
-        input[1] = event.Data2;
-        input[2] = event.Data3;
-        if (length == UNDEFINED) {
-            // sysex
-            if (event.Event == MIDI_EVENT(0, SYSEX_START_OR_CONT) || event.Event == MIDI_EVENT(0, SYSEX_ENDS_IN_3)) {
-                length = 3;
-            } else if (event.Event == MIDI_EVENT(0, SYSEX_ENDS_IN_2)) {
-                length = 2;
-            } else if (event.Event == MIDI_EVENT(0, SYSEX_ENDS_IN_1)) {
-                length = 1;
-            } else {
-                // XXX what to do?
+    MIDI_EventPacket_t events[MIDI_PACKETS_PER_TRANSFER];
+    uint8_t            count;
+    while ((count = recv_midi_packets(events, MIDI_PACKETS_PER_TRANSFER)) > 0) {
+        for (uint8_t i = 0; i < count; i++) {
+            MIDI_EventPacket_t*  event  = &events[i];
+            midi_packet_length_t length = midi_packet_length(event->Data1);
+            if (length == UNDEFINED) {
+                // sysex
+                if (event->Event == MIDI_EVENT(0, SYSEX_START_OR_CONT) || event->Event == MIDI_EVENT(0, SYSEX_ENDS_IN_3)) {
+                    length = 3;
+                } else if (event->Event == MIDI_EVENT(0, SYSEX_ENDS_IN_2)) {
+                    length = 2;
+                } else if (event->Event == MIDI_EVENT(0, SYSEX_ENDS_IN_1)) {
+                    length = 1;
+                } else {
+                    // XXX what to do?
+                }
             }
-        }
 
-        // pass the data to the device input function
-        if (length != UNDEFINED) midi_device_input(device, length, input);
+            // parse the packet straight into the callbacks, it holds a whole message or a piece of sysex
+            if (length != UNDEFINED) midi_device_input_packet(device, length, &event->Data1);
+        }
     }
 }
 
@@ -7,4 +7,7 @@ extern MidiDevice midi_device;
 void              setup_midi(void);
 void              send_midi_packet(MIDI_EventPacket_t* event);
 bool              recv_midi_packet(MIDI_EventPacket_t* const event);
+void              send_midi_packets(MIDI_EventPacket_t* events, uint8_t count);
+uint8_t           recv_midi_packets(MIDI_EventPacket_t* const events, uint8_t max_count);
+void              flush_midi_packets(void);
 #endif
@@ -0,0 +1,111 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "midi.h"
+#include "bytequeue/interrupt_setting.h"
+
+interrupt_setting_t store_and_clear_interrupt(void) {
+    return 0;
+}
+
+void restore_interrupt_setting(interrupt_setting_t setting) {}
+}
+
+struct Call {
+    uint16_t cnt;
+    uint8_t  byte0, byte1, byte2;
+
+    bool operator==(const Call &other) const {
+        return cnt == other.cnt && byte0 == other.byte0 && byte1 == other.byte1 && byte2 == other.byte2;
+    }
+};
+
+static std::vector<Call> catchall_calls;
+static std::vector<Call> sysex_calls;
+static std::vector<Call> noteon_calls;
+
+static void catchall_callback(MidiDevice *device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    catchall_calls.push_back({cnt, byte0, byte1, byte2});
+}
+
+static void sysex_callback(MidiDevice *device, uint16_t start, uint8_t length, uint8_t *data) {
+    sysex_calls.push_back({start, length, data[0], length > 1 ? data[1] : (uint8_t)0});
+}
+
+static void noteon_callback(MidiDevice *device, uint8_t chan, uint8_t num, uint8_t val) {
+    noteon_calls.push_back({3, chan, num, val});
+}
+
+// Messages as USB-MIDI packets carry them: a note, running clock, a sysex split over packets, and a song position
+static const std::vector<std::vector<uint8_t>> messages = {
+    {MIDI_NOTEON | 2, 60, 100}, {MIDI_CLOCK}, {SYSEX_BEGIN, 0x7D, 0x01}, {MIDI_CLOCK}, {0x02, 0x03, 0x04}, {0x05, SYSEX_END}, {MIDI_SONGPOSITION, 0x10, 0x20}, {MIDI_PROGCHANGE | 1, 5}, {MIDI_TUNEREQUEST}, {MIDI_NOTEON | 2, 62, 0},
+};
+
+class MidiDeviceTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        midi_device_init(&device);
+        midi_register_catchall_callback(&device, catchall_callback);
+        midi_register_sysex_callback(&device, sysex_callback);
+        midi_register_noteon_callback(&device, noteon_callback);
+        catchall_calls.clear();
+        sysex_calls.clear();
+        noteon_calls.clear();
+    }
+
+    MidiDevice device;
+};
+
+TEST_F(MidiDeviceTest, PacketsMatchQueuedInput) {
+    for (auto message : messages) {
+        midi_device_input(&device, message.size(), message.data());
+    }
+    midi_device_process(&device);
+
+    std::vector<Call> queued_catchall = catchall_calls;
+    std::vector<Call> queued_sysex    = sysex_calls;
+    std::vector<Call> queued_noteon   = noteon_calls;
+    EXPECT_EQ(queued_noteon.size(), 2u);
+    EXPECT_EQ(queued_sysex.size(), 3u);
+
+    SetUp();
+    for (auto message : messages) {
+        midi_device_input_packet(&device, message.size(), message.data());
+    }
+    EXPECT_EQ(catchall_calls, queued_catchall);
+    EXPECT_EQ(sysex_calls, queued_sysex);
+    EXPECT_EQ(noteon_calls, queued_noteon);
+}
+
+TEST_F(MidiDeviceTest, RunningStatusAfterPacket) {
+    uint8_t note[] = {MIDI_NOTEON, 60, 100};
+    midi_device_input_packet(&device, sizeof(note), note);
+
+    // Data bytes without a status byte continue the last message
+    uint8_t running[] = {64, 90};
+    midi_device_input_packet(&device, sizeof(running), running);
+
+    ASSERT_EQ(noteon_calls.size(), 2u);
+    EXPECT_EQ(noteon_calls[1], (Call{3, 0, 64, 90}));
+}
+
+TEST_F(MidiDeviceTest, FullQueueDropsWholeMessages) {
+    uint8_t note[] = {MIDI_NOTEON, 60, 100};
+    while (bytequeue_length(&device.input_queue) + sizeof(note) < MIDI_INPUT_QUEUE_LENGTH) {
+        midi_device_input(&device, sizeof(note), note);
+    }
+    byteQueueIndex_t length = bytequeue_length(&device.input_queue);
+
+    // Does not fit, and must not leave part of the message behind
+    midi_device_input(&device, sizeof(note), note);
+    EXPECT_EQ(bytequeue_length(&device.input_queue), length);
+
+    midi_device_process(&device);
+    EXPECT_EQ(bytequeue_length(&device.input_queue), 0);
+    EXPECT_EQ(noteon_calls.size(), length / sizeof(note));
+}
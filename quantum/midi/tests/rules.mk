@@ -0,0 +1,13 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+midi_device_DEFS := -DNO_DEBUG
+
+midi_device_INC := \
+	$(QUANTUM_PATH)/midi
+
+midi_device_SRC := \
+	$(QUANTUM_PATH)/midi/tests/midi_device_tests.cpp \
+	$(QUANTUM_PATH)/midi/midi.c \
+	$(QUANTUM_PATH)/midi/midi_device.c \
+	$(QUANTUM_PATH)/midi/bytequeue/bytequeue.c
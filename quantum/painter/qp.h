@@ -353,6 +353,20 @@ bool qp_pixdata(painter_device_t device, const void *pixel_data, uint32_t native
  */
 painter_image_handle_t qp_load_image_mem(const void *buffer);
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+/**
+ * Loads an image stored in external SPI flash.
+ *
+ * @note Images can be unloaded by calling \ref qp_close_image. Image data is read from the flash as it is drawn.
+ *
+ * @param address[in] the flash address of the start of the image data
+ * @return an image handle usable with \ref qp_drawimage, \ref qp_drawimage_recolor, \ref qp_animate, and
+ *         \ref qp_animate_recolor.
+ * @return NULL if loading the image failed
+ */
+painter_image_handle_t qp_load_image_flash(uint32_t address);
+#endif // QP_STREAM_HAS_FLASH_IO
+
 /**
  * Closes an image handle when no longer in use.
  *
@@ -440,6 +454,20 @@ void qp_stop_animation(deferred_token anim_token);
  */
 painter_font_handle_t qp_load_font_mem(const void *buffer);
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+/**
+ * Loads a font stored in external SPI flash.
+ *
+ * @note Fonts can be unloaded by calling \ref qp_close_font. Font data is read from the flash as it is drawn, unless
+ *       \ref QUANTUM_PAINTER_LOAD_FONTS_TO_RAM is set to TRUE.
+ *
+ * @param address[in] the flash address of the start of the font data
+ * @return an image handle usable with \ref qp_textwidth, \ref qp_drawtext, and \ref qp_drawtext_recolor.
+ * @return NULL if loading the font failed
+ */
+painter_font_handle_t qp_load_font_flash(uint32_t address);
+#endif // QP_STREAM_HAS_FLASH_IO
+
 /**
  * Closes a font handle when no longer in use.
  *
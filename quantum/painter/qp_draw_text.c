@@ -27,6 +27,9 @@ typedef struct qff_font_handle_t {
 #ifdef QP_STREAM_HAS_FILE_IO
         qp_file_stream_t file_stream;
 #endif // QP_STREAM_HAS_FILE_IO
+#ifdef QP_STREAM_HAS_FLASH_IO
+        qp_flash_stream_t flash_stream;
+#endif // QP_STREAM_HAS_FLASH_IO
     };
 #if QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
     bool  owns_buffer;
@@ -73,21 +76,24 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
     font->owns_buffer = false;
     font->buffer      = NULL;
 
-    void *ram_buffer = malloc(font->mem_stream.length);
+    // Works for any stream type, so fonts stored in external flash can also be copied into RAM
+    uint32_t font_length = qff_get_total_size(&font->stream);
+    void *   ram_buffer  = malloc(font_length);
     if (ram_buffer == NULL) {
         qp_dprintf("qp_load_font: could not allocate enough RAM for font, falling back to original\n");
     } else {
         do {
             // Copy the data into RAM
-            if (qp_stream_read(ram_buffer, 1, font->mem_stream.length, &font->mem_stream) != font->mem_stream.length) {
+            if (qp_stream_setpos(&font->stream, 0) < 0 || qp_stream_read(ram_buffer, 1, font_length, &font->stream) != font_length) {
                 qp_dprintf("qp_load_font: could not copy from flash to RAM, falling back to original\n");
                 break;
             }
 
             // Create the new stream with the new buffer
+            qp_stream_close(&font->stream);
             font->buffer      = ram_buffer;
             font->owns_buffer = true;
-            font->mem_stream  = qp_make_memory_stream(font->buffer, font->mem_stream.length);
+            font->mem_stream  = qp_make_memory_stream(font->buffer, font_length);
         } while (0);
     }
 
@@ -132,6 +138,30 @@ painter_font_handle_t qp_load_font_mem(const void *buffer) {
     return qp_load_font_internal(font_mem_stream_factory, (void *)buffer);
 }
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_font_flash
+
+static inline bool font_flash_stream_factory(qff_font_handle_t *font, void *arg) {
+    uint32_t address = *(uint32_t *)arg;
+
+    // Assume we can read the font descriptor
+    font->flash_stream = qp_make_flash_stream(address, sizeof(qff_font_descriptor_v1_t));
+
+    // Update the length of the stream to match, and rewind to the start
+    font->flash_stream.length   = qff_get_total_size(&font->stream);
+    font->flash_stream.position = 0;
+
+    return true;
+}
+
+painter_font_handle_t qp_load_font_flash(uint32_t address) {
+    return qp_load_font_internal(font_flash_stream_factory, &address);
+}
+
+#endif // QP_STREAM_HAS_FLASH_IO
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_close_font
 
@@ -1,6 +1,7 @@
 // Copyright 2021 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <string.h>
 #include "qp_stream.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +10,10 @@
 uint32_t qp_stream_read_impl(void *output_buf, uint32_t member_size, uint32_t num_members, qp_stream_t *stream) {
     uint8_t *output_ptr = (uint8_t *)output_buf;
 
+    if (stream->read) {
+        return stream->read(stream, output_ptr, num_members * member_size) / member_size;
+    }
+
     uint32_t i;
     for (i = 0; i < (num_members * member_size); ++i) {
         int16_t c = qp_stream_get(stream);
@@ -164,3 +169,183 @@ qp_file_stream_t qp_make_file_stream(FILE *f) {
     return stream;
 }
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// External flash streams
+
+#ifdef QP_STREAM_HAS_FLASH_IO
+
+#    define FLASH_CACHE_BLOCK_INVALID UINT32_MAX
+
+typedef struct qp_flash_cache_block_t {
+    uint32_t address; // block-aligned flash address held, or FLASH_CACHE_BLOCK_INVALID
+    uint8_t  age;     // 0 is most recently used
+    uint8_t  data[QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE];
+} qp_flash_cache_block_t;
+
+static qp_flash_cache_block_t flash_cache[QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT];
+static bool                   flash_cache_initialised = false;
+
+void qp_flash_stream_invalidate_cache(void) {
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT; ++i) {
+        flash_cache[i].address = FLASH_CACHE_BLOCK_INVALID;
+        flash_cache[i].age     = i;
+    }
+    flash_cache_initialised = true;
+}
+
+// Cached blocks would be stale once the flash is written at runtime
+void flash_contents_changing(void) {
+    qp_flash_stream_invalidate_cache();
+}
+
+static void flash_cache_touch(qp_flash_cache_block_t *block) {
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT; ++i) {
+        if (flash_cache[i].age < block->age) {
+            flash_cache[i].age++;
+        }
+    }
+    block->age = 0;
+}
+
+// Returns the cache block holding the supplied flash address, reading it from the flash (and evicting the least
+// recently used block) if required. Returns NULL if the flash could not be read.
+static qp_flash_cache_block_t *flash_cache_get(uint32_t address) {
+    if (!flash_cache_initialised) {
+        qp_flash_stream_invalidate_cache();
+    }
+
+    uint32_t                block_address = address - (address % QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE);
+    qp_flash_cache_block_t *victim        = &flash_cache[0];
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT; ++i) {
+        if (flash_cache[i].address == block_address) {
+            flash_cache_touch(&flash_cache[i]);
+            return &flash_cache[i];
+        }
+        if (flash_cache[i].age > victim->age) {
+            victim = &flash_cache[i];
+        }
+    }
+
+    if (flash_read_block(block_address, victim->data, QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE) != FLASH_STATUS_SUCCESS) {
+        victim->address = FLASH_CACHE_BLOCK_INVALID;
+        return NULL;
+    }
+    victim->address = block_address;
+    flash_cache_touch(victim);
+    return victim;
+}
+
+static inline int16_t flash_get(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return STREAM_EOF;
+    }
+
+    uint32_t                address = s->address + s->position;
+    qp_flash_cache_block_t *block   = flash_cache_get(address);
+    if (!block) {
+        return STREAM_EOF;
+    }
+
+    s->position++;
+    return block->data[address - block->address];
+}
+
+static inline uint32_t flash_read(qp_stream_t *stream, uint8_t *output_buf, uint32_t length) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    if (s->position + (int32_t)length > s->length) {
+        length    = s->length - s->position;
+        s->is_eof = true;
+    }
+
+    // Reads spanning more than a cache block go straight to the flash in a single transfer, rather than evicting
+    // everything else from the cache
+    if (length > QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE) {
+        if (flash_read_block(s->address + s->position, output_buf, length) != FLASH_STATUS_SUCCESS) {
+            return 0;
+        }
+        s->position += length;
+        return length;
+    }
+
+    uint32_t i = 0;
+    while (i < length) {
+        uint32_t                address = s->address + s->position;
+        qp_flash_cache_block_t *block   = flash_cache_get(address);
+        if (!block) {
+            break;
+        }
+
+        uint32_t block_offset = address - block->address;
+        uint32_t this_length  = QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE - block_offset;
+        if (this_length > length - i) {
+            this_length = length - i;
+        }
+
+        memcpy(&output_buf[i], &block->data[block_offset], this_length);
+        s->position += this_length;
+        i += this_length;
+    }
+    return i;
+}
+
+static inline bool flash_put(qp_stream_t *stream, uint8_t c) {
+    // Read-only, assets are programmed into the flash outside of Quantum Painter
+    return false;
+}
+
+static inline int flash_seek(qp_stream_t *stream, int32_t offset, int origin) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+
+    // Handle as per fseek
+    int32_t position = s->position;
+    switch (origin) {
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position += offset;
+            break;
+        case SEEK_END:
+            position = s->length + offset;
+            break;
+        default:
+            return -1;
+    }
+
+    if (position < 0 || position > s->length) {
+        return -1;
+    }
+
+    s->position = position;
+    s->is_eof   = false;
+    return 0;
+}
+
+static inline int32_t flash_tell(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->position;
+}
+
+static inline bool flash_is_eof(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->is_eof;
+}
+
+static inline void flash_close(qp_stream_t *stream) {
+    // No-op.
+}
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length) {
+    qp_flash_stream_t stream = {
+        .base     = {.get = flash_get, .put = flash_put, .seek = flash_seek, .tell = flash_tell, .is_eof = flash_is_eof, .close = flash_close, .read = flash_read},
+        .address  = address,
+        .length   = length,
+        .position = 0,
+    };
+    return stream;
+}
+
+#endif // QP_STREAM_HAS_FLASH_IO
@@ -23,6 +23,10 @@
 
 #include "qp_internal.h"
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+#    include "flash_spi.h"
+#endif // QP_STREAM_HAS_FLASH_IO
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Stream API
 
@@ -55,6 +59,7 @@ typedef struct qp_stream_t {
     int32_t (*tell)(qp_stream_t *stream);
     bool (*is_eof)(qp_stream_t *stream);
     void (*close)(qp_stream_t *stream);
+    uint32_t (*read)(qp_stream_t *stream, uint8_t *output_buf, uint32_t length); // optional bulk read, falls back to get()
 } qp_stream_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -83,3 +88,30 @@ typedef struct qp_file_stream_t {
 qp_file_stream_t qp_make_file_stream(FILE *f);
 
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// External flash streams
+
+#ifdef QP_STREAM_HAS_FLASH_IO
+
+// Flash streams share a small cache of blocks read from the external flash
+#    ifndef QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE
+#        define QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE 64
+#    endif // QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE
+
+#    ifndef QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT
+#        define QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT 4
+#    endif // QUANTUM_PAINTER_FLASH_CACHE_BLOCK_COUNT
+
+typedef struct qp_flash_stream_t {
+    qp_stream_t base;
+    uint32_t    address;
+    int32_t     length;
+    int32_t     position;
+    bool        is_eof;
+} qp_flash_stream_t;
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length);
+void              qp_flash_stream_invalidate_cache(void);
+
+#endif // QP_STREAM_HAS_FLASH_IO
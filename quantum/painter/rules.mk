@@ -43,6 +43,11 @@ ifeq ($(strip $(QUANTUM_PAINTER_ANIMATIONS_ENABLE)), yes)
     OPT_DEFS += -DQUANTUM_PAINTER_ANIMATIONS_ENABLE
 endif
 
+# Allow assets to be streamed from external SPI flash
+ifeq ($(strip $(FLASH_DRIVER)), spi)
+    OPT_DEFS += -DQP_STREAM_HAS_FLASH_IO
+endif
+
 # Comms flags
 QUANTUM_PAINTER_NEEDS_COMMS_DUMMY ?= no
 QUANTUM_PAINTER_NEEDS_COMMS_SPI ?= no
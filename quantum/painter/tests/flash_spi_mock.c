@@ -0,0 +1,104 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <string.h>
+#include "spi_master.h"
+#include "flash_spi_mock.h"
+
+// Emulates the commands of a NOR FLASH chip which flash_spi.c issues, underneath the spi_master API
+
+uint8_t  mock_flash[EXTERNAL_FLASH_SIZE];
+uint32_t mock_flash_read_count = 0;
+
+static bool     selected = false;
+static uint8_t  command[EXTERNAL_FLASH_ADDRESS_SIZE + 2];
+static uint8_t  command_length = 0;
+static uint32_t data_offset    = 0;
+
+void mock_flash_reset(void) {
+    memset(mock_flash, 0xFF, sizeof(mock_flash));
+    mock_flash_read_count = 0;
+    selected              = false;
+}
+
+static uint32_t mock_flash_address(void) {
+    uint32_t address = 0;
+    for (int i = 1; i <= EXTERNAL_FLASH_ADDRESS_SIZE; i++) {
+        address = (address << 8) | command[i];
+    }
+    return address;
+}
+
+static void mock_flash_erase(uint32_t size) {
+    uint32_t address = mock_flash_address();
+    memset(&mock_flash[address - (address % size)], 0xFF, size);
+}
+
+static void mock_flash_shift_in(uint8_t byte) {
+    if (command_length < sizeof(command)) {
+        command[command_length++] = byte;
+        return;
+    }
+    if (command[0] == 0x02) { // PP, programming only clears bits
+        mock_flash[(mock_flash_address() + data_offset++) % EXTERNAL_FLASH_SIZE] &= byte;
+    }
+}
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    if (selected) {
+        return false;
+    }
+    selected       = true;
+    command_length = 0;
+    data_offset    = 0;
+    return true;
+}
+
+spi_status_t spi_write(uint8_t data) {
+    mock_flash_shift_in(data);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_read(void) {
+    // Only RDSR is read a byte at a time, and the chip is never busy
+    return 0;
+}
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        mock_flash_shift_in(data[i]);
+    }
+    // PP sends the address with the command, so anything after it is data
+    if (command[0] == 0x02 && command_length == EXTERNAL_FLASH_ADDRESS_SIZE + 1) {
+        command_length = sizeof(command);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    if (data_offset == 0) {
+        mock_flash_read_count++;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = mock_flash[(mock_flash_address() + data_offset++) % EXTERNAL_FLASH_SIZE];
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_stop(void) {
+    if (selected) {
+        switch (command[0]) {
+            case 0x20: // SE
+                mock_flash_erase(EXTERNAL_FLASH_SECTOR_SIZE);
+                break;
+            case 0xD8: // BE
+                mock_flash_erase(EXTERNAL_FLASH_BLOCK_SIZE);
+                break;
+            case 0x60: // CE
+                memset(mock_flash, 0xFF, sizeof(mock_flash));
+                break;
+        }
+    }
+    selected = false;
+}
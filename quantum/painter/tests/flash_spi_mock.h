@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include "flash_spi.h"
+
+// Contents of the emulated FLASH chip
+extern uint8_t mock_flash[EXTERNAL_FLASH_SIZE];
+
+// Number of read commands issued to the chip
+extern uint32_t mock_flash_read_count;
+
+void mock_flash_reset(void);
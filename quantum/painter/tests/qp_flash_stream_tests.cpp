@@ -0,0 +1,100 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "qp_stream.h"
+#include "flash_spi_mock.h"
+}
+
+#define ASSET_ADDRESS 0x1000
+#define ASSET_LENGTH 200
+
+class QPFlashStream : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        mock_flash_reset();
+        qp_flash_stream_invalidate_cache();
+        for (int i = 0; i < ASSET_LENGTH; i++) {
+            mock_flash[ASSET_ADDRESS + i] = i;
+        }
+    }
+};
+
+TEST_F(QPFlashStream, ReadsAssetBytes) {
+    qp_flash_stream_t stream = qp_make_flash_stream(ASSET_ADDRESS, ASSET_LENGTH);
+
+    EXPECT_EQ(qp_stream_get(&stream), 0);
+    EXPECT_EQ(qp_stream_get(&stream), 1);
+
+    uint8_t buf[10];
+    EXPECT_EQ(qp_stream_read(buf, 1, sizeof(buf), &stream), sizeof(buf));
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(buf[i], i + 2);
+    }
+    EXPECT_EQ(qp_stream_tell(&stream), 12);
+}
+
+TEST_F(QPFlashStream, RepeatedReadsHitTheCache) {
+    qp_flash_stream_t stream = qp_make_flash_stream(ASSET_ADDRESS, ASSET_LENGTH);
+
+    uint8_t buf[16];
+    qp_stream_read(buf, 1, sizeof(buf), &stream);
+    uint32_t reads = mock_flash_read_count;
+    EXPECT_EQ(reads, 1u);
+
+    qp_stream_setpos(&stream, 0);
+    qp_stream_read(buf, 1, sizeof(buf), &stream);
+    EXPECT_EQ(mock_flash_read_count, reads);
+}
+
+TEST_F(QPFlashStream, LargeReadsBypassTheCache) {
+    qp_flash_stream_t stream = qp_make_flash_stream(ASSET_ADDRESS, ASSET_LENGTH);
+
+    uint8_t buf[QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE * 2];
+    EXPECT_EQ(qp_stream_read(buf, 1, sizeof(buf), &stream), sizeof(buf));
+    EXPECT_EQ(buf[sizeof(buf) - 1], (uint8_t)(sizeof(buf) - 1));
+    EXPECT_EQ(mock_flash_read_count, 1u);
+
+    // Nothing was cached
+    qp_stream_setpos(&stream, 0);
+    qp_stream_get(&stream);
+    EXPECT_EQ(mock_flash_read_count, 2u);
+}
+
+TEST_F(QPFlashStream, StopsAtEndOfAsset) {
+    qp_flash_stream_t stream = qp_make_flash_stream(ASSET_ADDRESS, ASSET_LENGTH);
+
+    EXPECT_EQ(qp_stream_seek(&stream, -1, SEEK_END), 0);
+    EXPECT_EQ(qp_stream_get(&stream), ASSET_LENGTH - 1);
+    EXPECT_FALSE(qp_stream_eof(&stream));
+    EXPECT_EQ(qp_stream_get(&stream), STREAM_EOF);
+    EXPECT_TRUE(qp_stream_eof(&stream));
+    EXPECT_EQ(qp_stream_seek(&stream, 1, SEEK_END), -1);
+}
+
+TEST_F(QPFlashStream, WritesAreNotServedStaleFromTheCache) {
+    qp_flash_stream_t stream = qp_make_flash_stream(ASSET_ADDRESS, ASSET_LENGTH);
+    EXPECT_EQ(qp_stream_get(&stream), 0);
+
+    ASSERT_EQ(flash_erase_sector(ASSET_ADDRESS), FLASH_STATUS_SUCCESS);
+    const uint8_t update[] = {0xAA, 0xBB};
+    ASSERT_EQ(flash_write_block(ASSET_ADDRESS, update, sizeof(update)), FLASH_STATUS_SUCCESS);
+
+    qp_stream_setpos(&stream, 0);
+    EXPECT_EQ(qp_stream_get(&stream), 0xAA);
+    EXPECT_EQ(qp_stream_get(&stream), 0xBB);
+    EXPECT_EQ(qp_stream_get(&stream), 0xFF);
+}
+
+TEST_F(QPFlashStream, EraseIsNotServedStaleFromTheCache) {
+    qp_flash_stream_t stream = qp_make_flash_stream(ASSET_ADDRESS, ASSET_LENGTH);
+    qp_stream_setpos(&stream, 5);
+    EXPECT_EQ(qp_stream_get(&stream), 5);
+
+    ASSERT_EQ(flash_erase_chip(), FLASH_STATUS_SUCCESS);
+
+    qp_stream_setpos(&stream, 5);
+    EXPECT_EQ(qp_stream_get(&stream), 0xFF);
+}
@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Stands in for the full quantum.h included by qp_internal.h, the flash stream needs none of it
+
+#ifdef __cplusplus
+#    define _Static_assert static_assert
+#endif
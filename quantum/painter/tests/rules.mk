@@ -0,0 +1,28 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+qp_flash_stream_DEFS := -DNO_DEBUG -DNO_PRINT -DQP_STREAM_HAS_FLASH_IO -DEXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN=0
+
+qp_flash_stream_INC := \
+	$(QUANTUM_PATH)/painter/tests \
+	$(QUANTUM_PATH)/painter \
+	$(DRIVER_PATH)/flash \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers
+
+qp_flash_stream_SRC := \
+	$(QUANTUM_PATH)/painter/tests/qp_flash_stream_tests.cpp \
+	$(QUANTUM_PATH)/painter/tests/flash_spi_mock.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(DRIVER_PATH)/flash/flash_spi.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+# The same tests, with the flash driver's transactions going through the SPI queue
+qp_flash_stream_queued_DEFS := $(qp_flash_stream_DEFS) -DSPI_QUEUE_ENABLE
+
+qp_flash_stream_queued_INC := \
+	$(qp_flash_stream_INC) \
+	$(DRIVER_PATH)
+
+qp_flash_stream_queued_SRC := \
+	$(qp_flash_stream_SRC) \
+	$(DRIVER_PATH)/spi_queue.c
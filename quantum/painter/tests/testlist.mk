@@ -0,0 +1 @@
+TEST_LIST += qp_flash_stream qp_flash_stream_queued
@@ -81,6 +81,156 @@ static bool           pointing_device_force_send = false;
 
 extern const pointing_device_driver_t pointing_device_driver;
 
+// Motion processed but not yet sent to the host. Movement that does not fit into a single report, or that arrives
+// between paced reports, is carried over to the next report rather than being dropped.
+static int32_t accumulated_x = 0, accumulated_y = 0, accumulated_h = 0, accumulated_v = 0;
+
+/**
+ * @brief clamps int32_t to int8_t
+ *
+ * @param[in] int32_t value
+ * @return int8_t clamped value
+ */
+static inline int8_t pointing_device_hv_clamp(int32_t value) {
+    if (value < INT8_MIN) {
+        return INT8_MIN;
+    } else if (value > INT8_MAX) {
+        return INT8_MAX;
+    } else {
+        return value;
+    }
+}
+
+/**
+ * @brief clamps int32_t to mouse_xy_report_t
+ *
+ * @param[in] int32_t value
+ * @return mouse_xy_report_t clamped value
+ */
+static inline mouse_xy_report_t pointing_device_xy_clamp(int32_t value) {
+    if (value < XY_REPORT_MIN) {
+        return XY_REPORT_MIN;
+    } else if (value > XY_REPORT_MAX) {
+        return XY_REPORT_MAX;
+    } else {
+        return value;
+    }
+}
+
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT
+#    ifndef POINTING_DEVICE_MOTION_PIN
+#        error "POINTING_DEVICE_MOTION_INTERRUPT requires POINTING_DEVICE_MOTION_PIN"
+#    endif
+#    ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+#        error "POINTING_DEVICE_MOTION_INTERRUPT cannot be used with POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE"
+#    endif
+
+typedef struct {
+    uint32_t x, y, h, v; // running totals, which wrap; only differences between them are meaningful
+    uint8_t  buttons;
+} pointing_device_motion_t;
+
+// Motion read by the sampler, which may be an interrupt or a thread, and motion handed to the main loop so far. Each
+// side only writes its own totals, so neither waits for the other; the main loop just reads again if the sampler ran
+// part way through its copy, which the sequence count being odd or changed reveals.
+static pointing_device_motion_t motion_sampled  = {};
+static pointing_device_motion_t motion_drained  = {};
+static volatile uint8_t         motion_sequence = 0;
+
+// Ensures the totals are written before the sequence count publishing them
+#    define MOTION_PUBLISH() __asm__ volatile("" ::: "memory")
+
+/**
+ * @brief Whether the sensor is signalling motion on POINTING_DEVICE_MOTION_PIN
+ */
+bool pointing_device_motion_pin_active(void) {
+#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+    return !readPin(POINTING_DEVICE_MOTION_PIN);
+#    else
+    return readPin(POINTING_DEVICE_MOTION_PIN);
+#    endif
+}
+
+/**
+ * @brief Reads the sensor and adds its motion to the sampled totals
+ *
+ * Called by the motion backend while the motion pin is active, independently of the main loop.
+ */
+void pointing_device_motion_sample(void) {
+    // The sensor's own button state is kept between reads, as it would be in the main loop's report
+    static report_mouse_t sensor_report = {};
+    sensor_report.x                     = 0;
+    sensor_report.y                     = 0;
+    sensor_report.h                     = 0;
+    sensor_report.v                     = 0;
+    sensor_report                       = pointing_device_driver.get_report(sensor_report);
+
+    motion_sequence++;
+    MOTION_PUBLISH();
+    motion_sampled.x += (int32_t)sensor_report.x;
+    motion_sampled.y += (int32_t)sensor_report.y;
+    motion_sampled.h += (int32_t)sensor_report.h;
+    motion_sampled.v += (int32_t)sensor_report.v;
+    motion_sampled.buttons = sensor_report.buttons;
+    MOTION_PUBLISH();
+    motion_sequence++;
+}
+
+/**
+ * @brief Takes as much sampled motion as `mouse_report` can hold
+ *
+ * This replaces the driver's get_report() in the main loop. Motion that does not fit is left for the next call, and
+ * only buttons changed by the sensor since the last call are applied, so buttons set from the keymap are kept.
+ */
+report_mouse_t pointing_device_motion_get_report(report_mouse_t mouse_report) {
+    pointing_device_motion_backend_task();
+
+    pointing_device_motion_t sampled;
+    uint8_t                  sequence;
+    do {
+        sequence = motion_sequence;
+        MOTION_PUBLISH();
+        sampled = motion_sampled;
+        MOTION_PUBLISH();
+    } while ((sequence & 1) || sequence != motion_sequence);
+
+    mouse_report.x = pointing_device_xy_clamp((int32_t)(sampled.x - motion_drained.x));
+    mouse_report.y = pointing_device_xy_clamp((int32_t)(sampled.y - motion_drained.y));
+    mouse_report.h = pointing_device_hv_clamp((int32_t)(sampled.h - motion_drained.h));
+    mouse_report.v = pointing_device_hv_clamp((int32_t)(sampled.v - motion_drained.v));
+    motion_drained.x += (int32_t)mouse_report.x;
+    motion_drained.y += (int32_t)mouse_report.y;
+    motion_drained.h += (int32_t)mouse_report.h;
+    motion_drained.v += (int32_t)mouse_report.v;
+
+    uint8_t changed        = sampled.buttons ^ motion_drained.buttons;
+    mouse_report.buttons   = (mouse_report.buttons & ~changed) | (sampled.buttons & changed);
+    motion_drained.buttons = sampled.buttons;
+    return mouse_report;
+}
+
+/**
+ * @brief Arms the motion interrupt; platforms without a backend are sampled from the main loop instead
+ */
+__attribute__((weak)) void pointing_device_motion_backend_init(void) {}
+
+/**
+ * @brief Samples the sensor from the main loop, for platforms without an interrupt driven backend
+ */
+__attribute__((weak)) void pointing_device_motion_backend_task(void) {
+    if (pointing_device_motion_pin_active()) {
+        pointing_device_motion_sample();
+    }
+}
+
+/**
+ * @brief Reads the sensor, or the motion sampled from it
+ */
+#    define pointing_device_read_sensor(mouse_report) pointing_device_motion_get_report(mouse_report)
+#else
+#    define pointing_device_read_sensor(mouse_report) pointing_device_driver.get_report(mouse_report)
+#endif
+
 /**
  * @brief Keyboard level code pointing device initialisation
  *
@@ -153,6 +303,9 @@ __attribute__((weak)) void pointing_device_init(void) {
 #    else
         setPinInput(POINTING_DEVICE_MOTION_PIN);
 #    endif
+#endif
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT
+        pointing_device_motion_backend_init();
 #endif
     }
 
@@ -218,6 +371,46 @@ report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report) {
     return mouse_report;
 }
 
+/**
+ * @brief Moves the motion of the local mouse report into the accumulator, then fills it with as much accumulated motion
+ * as a single report can hold.
+ *
+ * When POINTING_DEVICE_REPORT_INTERVAL_MS is set, motion is only released once per interval, unless the buttons have
+ * changed, so sensors polled faster than the host do not flood the endpoint.
+ */
+static void pointing_device_accumulate(void) {
+    accumulated_x += local_mouse_report.x;
+    accumulated_y += local_mouse_report.y;
+    accumulated_h += local_mouse_report.h;
+    accumulated_v += local_mouse_report.v;
+
+    local_mouse_report.x = 0;
+    local_mouse_report.y = 0;
+    local_mouse_report.h = 0;
+    local_mouse_report.v = 0;
+
+#if (POINTING_DEVICE_REPORT_INTERVAL_MS > 0)
+    static uint32_t last_report  = 0;
+    static uint8_t  last_buttons = 0;
+    if (local_mouse_report.buttons == last_buttons && timer_elapsed32(last_report) < POINTING_DEVICE_REPORT_INTERVAL_MS) {
+        return;
+    }
+    last_buttons = local_mouse_report.buttons;
+    if (accumulated_x || accumulated_y || accumulated_h || accumulated_v) {
+        last_report = timer_read32();
+    }
+#endif
+
+    local_mouse_report.x = pointing_device_xy_clamp(accumulated_x);
+    local_mouse_report.y = pointing_device_xy_clamp(accumulated_y);
+    local_mouse_report.h = pointing_device_hv_clamp(accumulated_h);
+    local_mouse_report.v = pointing_device_hv_clamp(accumulated_v);
+    accumulated_x -= local_mouse_report.x;
+    accumulated_y -= local_mouse_report.y;
+    accumulated_h -= local_mouse_report.h;
+    accumulated_v -= local_mouse_report.v;
+}
+
 /**
  * @brief Retrieves and processes pointing device data.
  *
@@ -242,7 +435,7 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #endif
 
     // Gather report info
-#ifdef POINTING_DEVICE_MOTION_PIN
+#if defined(POINTING_DEVICE_MOTION_PIN) && !defined(POINTING_DEVICE_MOTION_INTERRUPT)
 #    if defined(SPLIT_POINTING_ENABLE)
 #        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
 #    endif
@@ -257,15 +450,15 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #    if defined(POINTING_DEVICE_COMBINED)
         static uint8_t old_buttons = 0;
     local_mouse_report.buttons = old_buttons;
-    local_mouse_report         = pointing_device_driver.get_report(local_mouse_report);
+    local_mouse_report         = pointing_device_read_sensor(local_mouse_report);
     old_buttons                = local_mouse_report.buttons;
 #    elif defined(POINTING_DEVICE_LEFT) || defined(POINTING_DEVICE_RIGHT)
-        local_mouse_report = POINTING_DEVICE_THIS_SIDE ? pointing_device_driver.get_report(local_mouse_report) : shared_mouse_report;
+        local_mouse_report = POINTING_DEVICE_THIS_SIDE ? pointing_device_read_sensor(local_mouse_report) : shared_mouse_report;
 #    else
 #        error "You need to define the side(s) the pointing device is on. POINTING_DEVICE_COMBINED / POINTING_DEVICE_LEFT / POINTING_DEVICE_RIGHT"
 #    endif
 #else
-    local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    local_mouse_report = pointing_device_read_sensor(local_mouse_report);
 #endif // defined(SPLIT_POINTING_ENABLE)
 
     // allow kb to intercept and modify report
@@ -291,6 +484,7 @@ __attribute__((weak)) bool pointing_device_task(void) {
     report_mouse_t mousekey_report = mousekey_get_report();
     local_mouse_report.buttons     = local_mouse_report.buttons | mousekey_report.buttons;
 #endif
+    pointing_device_accumulate();
 
     const bool send_report     = pointing_device_send() || pointing_device_force_send;
     pointing_device_force_send = false;
@@ -371,37 +565,6 @@ void pointing_device_set_cpi_on_side(bool left, uint16_t cpi) {
     }
 }
 
-/**
- * @brief clamps int16_t to int8_t
- *
- * @param[in] int16_t value
- * @return int8_t clamped value
- */
-static inline int8_t pointing_device_hv_clamp(int16_t value) {
-    if (value < INT8_MIN) {
-        return INT8_MIN;
-    } else if (value > INT8_MAX) {
-        return INT8_MAX;
-    } else {
-        return value;
-    }
-}
-
-/**
- * @brief clamps int16_t to int8_t
- *
- * @param[in] clamp_range_t value
- * @return mouse_xy_report_t clamped value
- */
-static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
-    if (value < XY_REPORT_MIN) {
-        return XY_REPORT_MIN;
-    } else if (value > XY_REPORT_MAX) {
-        return XY_REPORT_MAX;
-    } else {
-        return value;
-    }
-}
 /**
  * @brief combines 2 mouse reports and returns 2
  *
@@ -25,31 +25,47 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    include "pointing_device_auto_mouse.h"
 #endif
 
+#if defined(POINTING_DEVICE_DRIVER_pmw3360) && defined(POINTING_DEVICE_DRIVER_pmw3389)
+#    error "The PMW3360 and PMW3389 drivers share their code, so only one of them can be used at a time"
+#elif defined(POINTING_DEVICE_DRIVER_pmw3320) && (defined(POINTING_DEVICE_DRIVER_pmw3360) || defined(POINTING_DEVICE_DRIVER_pmw3389))
+#    error "The PMW3320 driver cannot be combined with the PMW3360 or PMW3389 drivers"
+#elif defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c) && defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_spi)
+#    error "The Cirque Pinnacle driver supports either I2C or SPI, not both"
+#endif
+
 #if defined(POINTING_DEVICE_DRIVER_adns5050)
 #    include "drivers/sensors/adns5050.h"
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#elif defined(POINTING_DEVICE_DRIVER_pmw3320)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_pmw3320)
 #    include "drivers/sensors/pmw3320.h"
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#elif defined(POINTING_DEVICE_DRIVER_adns9800)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_adns9800)
 #    include "spi_master.h"
 #    include "drivers/sensors/adns9800.h"
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#elif defined(POINTING_DEVICE_DRIVER_analog_joystick)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_analog_joystick)
 #    include "analog.h"
 #    include "drivers/sensors/analog_joystick.h"
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#elif defined(POINTING_DEVICE_DRIVER_azoteq_iqs5xx)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_azoteq_iqs5xx)
 #    include "i2c_master.h"
 #    include "drivers/sensors/azoteq_iqs5xx.h"
-#elif defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c) || defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_spi)
+#    include "pointing_device_gestures.h"
+#endif
+#if defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c) || defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_spi)
 #    include "drivers/sensors/cirque_pinnacle.h"
 #    include "drivers/sensors/cirque_pinnacle_gestures.h"
 #    include "pointing_device_gestures.h"
-#elif defined(POINTING_DEVICE_DRIVER_paw3204)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_paw3204)
 #    include "drivers/sensors/paw3204.h"
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#elif defined(POINTING_DEVICE_DRIVER_pimoroni_trackball)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_pimoroni_trackball)
 #    include "i2c_master.h"
 #    include "drivers/sensors/pimoroni_trackball.h"
 // support for legacy pimoroni defines
@@ -63,11 +79,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        define POINTING_DEVICE_ROTATION_90
 #    endif
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#elif defined(POINTING_DEVICE_DRIVER_pmw3360) || defined(POINTING_DEVICE_DRIVER_pmw3389)
+#endif
+#if defined(POINTING_DEVICE_DRIVER_pmw3360) || defined(POINTING_DEVICE_DRIVER_pmw3389)
 #    include "spi_master.h"
 #    include "drivers/sensors/pmw33xx_common.h"
 #    define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-#else
+report_mouse_t pmw33xx_get_sensor_report(uint8_t sensor, report_mouse_t mouse_report);
+#endif
+#if defined(POINTING_DEVICE_DRIVER_custom)
 void           pointing_device_driver_init(void);
 report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report);
 uint16_t       pointing_device_driver_get_cpi(void);
@@ -81,6 +100,41 @@ typedef struct {
     uint16_t (*get_cpi)(void);
 } pointing_device_driver_t;
 
+#if defined(POINTING_DEVICE_MULTIPLE_DRIVERS) && !defined(POINTING_DEVICE_SENSOR_COUNT)
+#    error "More than one POINTING_DEVICE_DRIVER requires a sensor table, see POINTING_DEVICE_SENSOR_COUNT"
+#endif
+
+#ifdef POINTING_DEVICE_SENSOR_COUNT
+/* With a sensor table, each driver is named after its type, e.g. pmw33xx_pointing_device_driver, and
+ * pointing_device_driver reads every sensor in the table and combines their motion. */
+#    define POINTING_DEVICE_DRIVER_OBJECT(name) name##_pointing_device_driver
+
+typedef struct {
+    const pointing_device_driver_t *driver;
+    uint16_t                        interval; // milliseconds between reads, 0 to read on every task
+} pointing_device_sensor_t;
+
+extern const pointing_device_sensor_t pointing_device_sensors[POINTING_DEVICE_SENSOR_COUNT];
+
+extern const pointing_device_driver_t adns5050_pointing_device_driver;
+extern const pointing_device_driver_t adns9800_pointing_device_driver;
+extern const pointing_device_driver_t analog_joystick_pointing_device_driver;
+extern const pointing_device_driver_t azoteq_iqs5xx_pointing_device_driver;
+extern const pointing_device_driver_t cirque_pinnacle_pointing_device_driver;
+extern const pointing_device_driver_t paw3204_pointing_device_driver;
+extern const pointing_device_driver_t pimoroni_trackball_pointing_device_driver;
+extern const pointing_device_driver_t pmw3320_pointing_device_driver;
+extern const pointing_device_driver_t pmw33xx_pointing_device_driver;
+extern const pointing_device_driver_t custom_pointing_device_driver;
+
+uint16_t       pointing_device_get_sensor_cpi(uint8_t sensor);
+void           pointing_device_set_sensor_cpi(uint8_t sensor, uint16_t cpi);
+report_mouse_t pointing_device_task_sensor_kb(uint8_t sensor, report_mouse_t sensor_report);
+report_mouse_t pointing_device_task_sensor_user(uint8_t sensor, report_mouse_t sensor_report);
+#else
+#    define POINTING_DEVICE_DRIVER_OBJECT(name) pointing_device_driver
+#endif
+
 typedef enum {
     POINTING_DEVICE_BUTTON1,
     POINTING_DEVICE_BUTTON2,
@@ -102,6 +156,10 @@ typedef int32_t clamp_range_t;
 typedef int16_t clamp_range_t;
 #endif
 
+#ifndef POINTING_DEVICE_REPORT_INTERVAL_MS
+#    define POINTING_DEVICE_REPORT_INTERVAL_MS 0
+#endif
+
 void           pointing_device_init(void);
 bool           pointing_device_task(void);
 bool           pointing_device_send(void);
@@ -118,6 +176,14 @@ uint8_t        pointing_device_handle_buttons(uint8_t buttons, bool pressed, poi
 report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report);
 void           pointing_device_keycode_handler(uint16_t keycode, bool pressed);
 
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT
+bool           pointing_device_motion_pin_active(void);
+void           pointing_device_motion_sample(void);
+report_mouse_t pointing_device_motion_get_report(report_mouse_t mouse_report);
+void           pointing_device_motion_backend_init(void);
+void           pointing_device_motion_backend_task(void);
+#endif
+
 #if defined(SPLIT_POINTING_ENABLE)
 void     pointing_device_set_shared_report(report_mouse_t report);
 uint16_t pointing_device_get_shared_cpi(void);
@@ -42,7 +42,7 @@ report_mouse_t adns5050_get_report(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(adns5050) = {
     .init         = adns5050_init,
     .get_report   = adns5050_get_report,
     .set_cpi      = adns5050_set_cpi,
@@ -50,7 +50,9 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#elif defined(POINTING_DEVICE_DRIVER_pmw3320)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_pmw3320)
 report_mouse_t pmw3320_get_report(report_mouse_t mouse_report) {
     report_pmw3320_t data = pmw3320_read_burst();
 
@@ -64,7 +66,7 @@ report_mouse_t pmw3320_get_report(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(pmw3320) = {
     .init         = pmw3320_init,
     .get_report   = pmw3320_get_report,
     .set_cpi      = pmw3320_set_cpi,
@@ -72,7 +74,9 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#elif defined(POINTING_DEVICE_DRIVER_adns9800)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_adns9800)
 
 report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
     report_adns9800_t sensor_report = adns9800_get_report();
@@ -84,7 +88,7 @@ report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(adns9800) = {
     .init       = adns9800_init,
     .get_report = adns9800_get_report_driver,
     .set_cpi    = adns9800_set_cpi,
@@ -92,7 +96,9 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#elif defined(POINTING_DEVICE_DRIVER_analog_joystick)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_analog_joystick)
 report_mouse_t analog_joystick_get_report(report_mouse_t mouse_report) {
     report_analog_joystick_t data = analog_joystick_read();
 
@@ -107,7 +113,7 @@ report_mouse_t analog_joystick_get_report(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(analog_joystick) = {
     .init       = analog_joystick_init,
     .get_report = analog_joystick_get_report,
     .set_cpi    = NULL,
@@ -115,10 +121,30 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#elif defined(POINTING_DEVICE_DRIVER_azoteq_iqs5xx)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_azoteq_iqs5xx)
 
 static i2c_status_t azoteq_iqs5xx_init_status = 1;
 
+#    ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+static bool azoteq_cursor_glide_enable = true;
+
+static cursor_glide_context_t azoteq_glide = {.config = {
+                                                  .coef       = 102, /* Good default friction coef */
+                                                  .interval   = AZOTEQ_IQS5XX_REPORT_RATE,
+                                                  .trigger_px = 10, /* Default threshold in case of hover, set to 0 if you'd like */
+                                              }};
+
+void azoteq_iqs5xx_enable_cursor_glide(bool enable) {
+    azoteq_cursor_glide_enable = enable;
+}
+
+void azoteq_iqs5xx_configure_cursor_glide(uint16_t trigger_px) {
+    azoteq_glide.config.trigger_px = trigger_px;
+}
+#    endif
+
 void azoteq_iqs5xx_init(void) {
     i2c_init();
     azoteq_iqs5xx_wake();
@@ -148,6 +174,13 @@ report_mouse_t azoteq_iqs5xx_get_report(report_mouse_t mouse_report) {
     report_mouse_t temp_report           = {0};
     static uint8_t previous_button_state = 0;
     static uint8_t read_error_count      = 0;
+#    ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+    cursor_glide_t glide_report = {0};
+
+    if (azoteq_cursor_glide_enable) {
+        glide_report = cursor_glide_check(&azoteq_glide);
+    }
+#    endif
 
     if (azoteq_iqs5xx_init_status == I2C_STATUS_SUCCESS) {
         azoteq_iqs5xx_base_data_t base_data = {0};
@@ -199,6 +232,22 @@ report_mouse_t azoteq_iqs5xx_get_report(report_mouse_t mouse_report) {
                 temp_report.x = CONSTRAIN_HID_XY(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.x.h, base_data.x.l));
                 temp_report.y = CONSTRAIN_HID_XY(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.y.h, base_data.y.l));
             }
+#    ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+            if (azoteq_cursor_glide_enable) {
+                if (base_data.number_of_fingers) {
+                    /* Only single finger cursor movement glides, gestures leave no movement to glide on */
+                    cursor_glide_update(&azoteq_glide, temp_report.x, temp_report.y, base_data.number_of_fingers);
+                } else {
+                    if (azoteq_glide.status.z) {
+                        glide_report = cursor_glide_start(&azoteq_glide);
+                    }
+                    if (glide_report.valid) {
+                        temp_report.x = glide_report.dx;
+                        temp_report.y = glide_report.dy;
+                    }
+                }
+            }
+#    endif
 
             previous_button_state = temp_report.buttons;
 
@@ -220,7 +269,7 @@ report_mouse_t azoteq_iqs5xx_get_report(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(azoteq_iqs5xx) = {
     .init       = azoteq_iqs5xx_init,
     .get_report = azoteq_iqs5xx_get_report,
     .set_cpi    = azoteq_iqs5xx_set_cpi,
@@ -228,22 +277,24 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#elif defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c) || defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_spi)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c) || defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_spi)
 #    ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
-static bool cursor_glide_enable = true;
+static bool cirque_cursor_glide_enable = true;
 
-static cursor_glide_context_t glide = {.config = {
-                                           .coef       = 102, /* Good default friction coef */
-                                           .interval   = 10,  /* 100sps */
-                                           .trigger_px = 10,  /* Default threshold in case of hover, set to 0 if you'd like */
-                                       }};
+static cursor_glide_context_t cirque_glide = {.config = {
+                                                  .coef       = 102, /* Good default friction coef */
+                                                  .interval   = 10,  /* 100sps */
+                                                  .trigger_px = 10,  /* Default threshold in case of hover, set to 0 if you'd like */
+                                              }};
 
 void cirque_pinnacle_enable_cursor_glide(bool enable) {
-    cursor_glide_enable = enable;
+    cirque_cursor_glide_enable = enable;
 }
 
-void cirque_pinnacle_configure_cursor_glide(float trigger_px) {
-    glide.config.trigger_px = trigger_px;
+void cirque_pinnacle_configure_cursor_glide(uint16_t trigger_px) {
+    cirque_glide.config.trigger_px = trigger_px;
 }
 #    endif
 
@@ -269,14 +320,14 @@ report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
     cursor_glide_t glide_report = {0};
 
-    if (cursor_glide_enable) {
-        glide_report = cursor_glide_check(&glide);
+    if (cirque_cursor_glide_enable) {
+        glide_report = cursor_glide_check(&cirque_glide);
     }
 #        endif
 
     if (!touchData.valid) {
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
-        if (cursor_glide_enable && glide_report.valid) {
+        if (cirque_cursor_glide_enable && glide_report.valid) {
             report_x = glide_report.dx;
             report_y = glide_report.dy;
             goto mouse_report_update;
@@ -306,11 +357,11 @@ report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
         last_scale = scale;
 
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
-        if (cursor_glide_enable) {
+        if (cirque_cursor_glide_enable) {
             if (touchData.touchDown) {
-                cursor_glide_update(&glide, report_x, report_y, touchData.zValue);
+                cursor_glide_update(&cirque_glide, report_x, report_y, touchData.zValue);
             } else if (!glide_report.valid) {
-                glide_report = cursor_glide_start(&glide);
+                glide_report = cursor_glide_start(&cirque_glide);
                 if (glide_report.valid) {
                     report_x = glide_report.dx;
                     report_y = glide_report.dy;
@@ -337,7 +388,7 @@ void cirque_pinnacle_set_cpi(uint16_t cpi) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(cirque_pinnacle) = {
     .init       = cirque_pinnacle_init,
     .get_report = cirque_pinnacle_get_report,
     .set_cpi    = cirque_pinnacle_set_cpi,
@@ -361,7 +412,7 @@ report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(cirque_pinnacle) = {
     .init       = cirque_pinnacle_init,
     .get_report = cirque_pinnacle_get_report,
     .set_cpi    = cirque_pinnacle_set_scale,
@@ -370,7 +421,9 @@ const pointing_device_driver_t pointing_device_driver = {
 // clang-format on
 #    endif
 
-#elif defined(POINTING_DEVICE_DRIVER_paw3204)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_paw3204)
 
 report_mouse_t paw3204_get_report(report_mouse_t mouse_report) {
     report_paw3204_t data = paw3204_read();
@@ -383,13 +436,15 @@ report_mouse_t paw3204_get_report(report_mouse_t mouse_report) {
 
     return mouse_report;
 }
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(paw3204) = {
     .init       = paw3204_init,
     .get_report = paw3204_get_report,
     .set_cpi    = paw3204_set_cpi,
     .get_cpi    = paw3204_get_cpi,
 };
-#elif defined(POINTING_DEVICE_DRIVER_pimoroni_trackball)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_pimoroni_trackball)
 
 mouse_xy_report_t pimoroni_trackball_adapt_values(clamp_range_t* offset) {
     if (*offset > XY_REPORT_MAX) {
@@ -439,7 +494,7 @@ report_mouse_t pimoroni_trackball_get_report(report_mouse_t mouse_report) {
 }
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(pimoroni_trackball) = {
     .init       = pimoroni_trackball_device_init,
     .get_report = pimoroni_trackball_get_report,
     .set_cpi    = pimoroni_trackball_set_cpi,
@@ -447,7 +502,11 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#elif defined(POINTING_DEVICE_DRIVER_pmw3360) || defined(POINTING_DEVICE_DRIVER_pmw3389)
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_pmw3360) || defined(POINTING_DEVICE_DRIVER_pmw3389)
+#    define PMW33XX_MAX_SENSORS MAX(ARRAY_SIZE((pin_t[])PMW33XX_CS_PINS), ARRAY_SIZE((pin_t[])PMW33XX_CS_PINS_RIGHT))
+
 static void pmw33xx_init_wrapper(void) {
     pmw33xx_init(0);
 }
@@ -460,22 +519,33 @@ static uint16_t pmw33xx_get_cpi_wrapper(void) {
     return pmw33xx_get_cpi(0);
 }
 
-report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
-    pmw33xx_report_t report    = pmw33xx_read_burst(0);
-    static bool      in_motion = false;
+/**
+ * @brief Reads one of the sensors on PMW33XX_CS_PINS
+ *
+ * The driver itself initialises and reads the first sensor, further sensors can be added to the sensor table with a
+ * driver that calls pmw33xx_init() and this with their index.
+ */
+report_mouse_t pmw33xx_get_sensor_report(uint8_t sensor, report_mouse_t mouse_report) {
+    static bool in_motion[PMW33XX_MAX_SENSORS] = {0};
+
+    if (sensor >= pmw33xx_number_of_sensors) {
+        return mouse_report;
+    }
+
+    pmw33xx_report_t report = pmw33xx_read_burst(sensor);
 
     if (report.motion.b.is_lifted) {
         return mouse_report;
     }
 
     if (!report.motion.b.is_motion) {
-        in_motion = false;
+        in_motion[sensor] = false;
         return mouse_report;
     }
 
-    if (!in_motion) {
-        in_motion = true;
-        pd_dprintf("PWM3360 (0): starting motion\n");
+    if (!in_motion[sensor]) {
+        in_motion[sensor] = true;
+        pd_dprintf("PWM3360 (%d): starting motion\n", sensor);
     }
 
     mouse_report.x = CONSTRAIN_HID_XY(report.delta_x);
@@ -483,8 +553,12 @@ report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
     return mouse_report;
 }
 
+report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
+    return pmw33xx_get_sensor_report(0, mouse_report);
+}
+
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(pmw33xx) = {
     .init       = pmw33xx_init_wrapper,
     .get_report = pmw33xx_get_report,
     .set_cpi    = pmw33xx_set_cpi_wrapper,
@@ -492,7 +566,9 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 // clang-format on
 
-#else
+#endif
+
+#if defined(POINTING_DEVICE_DRIVER_custom)
 __attribute__((weak)) void           pointing_device_driver_init(void) {}
 __attribute__((weak)) report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
     return mouse_report;
@@ -503,7 +579,7 @@ __attribute__((weak)) uint16_t pointing_device_driver_get_cpi(void) {
 __attribute__((weak)) void pointing_device_driver_set_cpi(uint16_t cpi) {}
 
 // clang-format off
-const pointing_device_driver_t pointing_device_driver = {
+const pointing_device_driver_t POINTING_DEVICE_DRIVER_OBJECT(custom) = {
     .init       = pointing_device_driver_init,
     .get_report = pointing_device_driver_get_report,
     .get_cpi    = pointing_device_driver_get_cpi,
@@ -13,10 +13,163 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <stdlib.h>
 #include <string.h>
 #include "pointing_device_gestures.h"
 #include "timer.h"
 
+static inline uint16_t sqrt32(uint32_t x) {
+    uint32_t l, m, h;
+
+    if (x == 0) {
+        return 0;
+    } else if (x > (UINT16_MAX >> 2)) {
+        /* Safe upper bound to avoid integer overflow with m * m */
+        h = UINT16_MAX;
+    } else {
+        /* Upper bound based on closest log2 */
+        h = (1 << (((__builtin_clzl(1) - __builtin_clzl(x) + 1) + 1) >> 1));
+    }
+    /* Lower bound based on closest log2 */
+    l = (1 << ((__builtin_clzl(1) - __builtin_clzl(x)) >> 1));
+
+    /* Binary search to find integer square root */
+    while (l != h - 1) {
+        m = (l + h) / 2;
+        if (m * m <= x) {
+            l = m;
+        } else {
+            h = m;
+        }
+    }
+    return l;
+}
+
+bool trackpad_tap_update(trackpad_tap_context_t* tap, bool touch_down, bool contact, uint16_t tapping_term, uint16_t debounce) {
+    bool tapped = false;
+
+    if (touch_down != tap->touchDown) {
+        tap->touchDown = touch_down;
+        if (!contact) {
+            if (timer_elapsed(tap->timer) < tapping_term && tap->timer != 0) {
+                tapped = true;
+            }
+        }
+        tap->timer = timer_read();
+    }
+    if (timer_elapsed(tap->timer) > debounce) {
+        tap->timer = 0;
+    }
+
+    return tapped;
+}
+
+static inline uint16_t atan2_16(int32_t dy, int32_t dx) {
+    if (dy == 0) {
+        if (dx >= 0) {
+            return 0;
+        } else {
+            return 32768;
+        }
+    }
+
+    int32_t abs_y = dy > 0 ? dy : -dy;
+    int16_t a;
+
+    if (dx >= 0) {
+        a = 8192 - (8192 * (dx - abs_y) / (dx + abs_y));
+    } else {
+        a = 24576 - (8192 * (dx + abs_y) / (abs_y - dx));
+    }
+
+    if (dy < 0) {
+        return -a; // negate if in quad III or IV
+    }
+    return a;
+}
+
+circular_scroll_t circular_scroll_update(circular_scroll_context_t* scroll, int8_t x, int8_t y, uint16_t z) {
+    circular_scroll_t report = {0, 0, false};
+    int8_t            wheel_clicks;
+    uint8_t           center = INT8_MAX;
+    uint16_t          mag;
+    int16_t           ang, dot, det, opposite_side, adjacent_side;
+
+    if (z) {
+        /* Check if first touch */
+        if (!scroll->z) {
+            report.suppress_touch = false;
+            /* Check if touch falls within outer ring */
+            mag = sqrt32(x * x + y * y);
+            if (mag * 100 / center >= 100 - scroll->config.outer_ring_pct) {
+                scroll->state = SCROLL_DETECTING;
+                scroll->x     = x;
+                scroll->y     = y;
+                scroll->mag   = mag;
+                /*
+                 * Decide scroll axis:
+                 *   Vertical if started from righ half
+                 *   Horizontal if started from left half
+                 * Flipped for left-handed
+                 */
+                scroll->axis = x < 0;
+            }
+        } else if (scroll->state == SCROLL_DETECTING) {
+            report.suppress_touch = true;
+            /* Already detecting scroll, check movement from touchdown location. Movement across the pad exceeds 16 bits when squared. */
+            mag = sqrt32((uint32_t)((x - scroll->x) * (x - scroll->x)) + (uint32_t)((y - scroll->y) * (y - scroll->y)));
+            if (mag >= scroll->config.trigger_px) {
+                /*
+                 * Find angle of movement.
+                 * 0 degrees here means movement towards center of circle
+                 */
+                dot           = scroll->x * x + scroll->y * y;
+                det           = scroll->x * y - scroll->y * x;
+                opposite_side = abs(det);                                  /* Based on scalar rejection */
+                adjacent_side = abs(scroll->mag * scroll->mag - abs(dot)); /* Based on scalar projection */
+                ang           = (int16_t)atan2_16(opposite_side, adjacent_side);
+                if (ang < scroll->config.trigger_ang) {
+                    /* Not a scroll, release coordinates */
+                    report.suppress_touch = false;
+                    scroll->state         = NOT_SCROLL;
+                } else {
+                    /* Scroll detected */
+                    scroll->state = SCROLL_VALID;
+                }
+            }
+        }
+        if (scroll->state == SCROLL_VALID) {
+            report.suppress_touch = true;
+            dot                   = scroll->x * x + scroll->y * y;
+            det                   = scroll->x * y - scroll->y * x;
+            ang                   = (int16_t)atan2_16(det, dot);
+            wheel_clicks          = ((int32_t)ang * scroll->config.wheel_clicks) / 65536;
+            if (wheel_clicks >= 1 || wheel_clicks <= -1) {
+                if (scroll->config.left_handed) {
+                    if (scroll->axis == 0) {
+                        report.h = -wheel_clicks;
+                    } else {
+                        report.v = wheel_clicks;
+                    }
+                } else {
+                    if (scroll->axis == 0) {
+                        report.v = -wheel_clicks;
+                    } else {
+                        report.h = wheel_clicks;
+                    }
+                }
+                scroll->x = x;
+                scroll->y = y;
+            }
+        }
+    }
+
+    scroll->z = z;
+    if (!scroll->z) scroll->state = SCROLL_UNINITIALIZED;
+
+    return report;
+}
+
 #ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
 #    ifdef POINTING_DEVICE_MOTION_PIN
 #        error POINTING_DEVICE_MOTION_PIN not supported when using inertial cursor. Need repeated calls to get_report() to generate glide events.
@@ -29,10 +182,9 @@ static void cursor_glide_stop(cursor_glide_context_t* glide) {
 static cursor_glide_t cursor_glide(cursor_glide_context_t* glide) {
     cursor_glide_status_t* status = &glide->status;
     cursor_glide_t         report;
-    int32_t                p;
     int32_t                x, y;
 
-    if (status->v0 == 0) {
+    if (status->dx0 == 0 && status->dy0 == 0) {
         report.dx    = 0;
         report.dy    = 0;
         report.valid = false;
@@ -40,17 +192,14 @@ static cursor_glide_t cursor_glide(cursor_glide_context_t* glide) {
         goto exit;
     }
 
-    status->counter++;
-    /* Calculate current 1D position */
-    p = status->v0 * status->counter - (int32_t)glide->config.coef * status->counter * status->counter / 2;
-    /*
-     * Translate to x & y axes
-     * Done this way instead of applying friction to each axis separately, so we don't end up with the shorter axis stuck at 0 towards the end of diagonal movements.
-     */
-    x            = (int32_t)(p * status->dx0 / status->v0);
-    y            = (int32_t)(p * status->dy0 / status->v0);
-    report.dx    = (mouse_xy_report_t)(x - status->x);
-    report.dy    = (mouse_xy_report_t)(y - status->y);
+    /* Advance by one report, velocity and friction were resolved into each axis when the glide started */
+    x = status->x + status->vx;
+    y = status->y + status->vy;
+    status->vx -= status->ax;
+    status->vy -= status->ay;
+
+    report.dx    = (mouse_xy_report_t)(x / 256 - status->x / 256);
+    report.dy    = (mouse_xy_report_t)(y / 256 - status->y / 256);
     report.valid = true;
     if (report.dx <= 1 && report.dx >= -1 && report.dy <= 1 && report.dy >= -1) {
         /* Stop gliding once speed is low enough */
@@ -76,50 +225,37 @@ cursor_glide_t cursor_glide_check(cursor_glide_context_t* glide) {
     }
 }
 
-static inline uint16_t sqrt32(uint32_t x) {
-    uint32_t l, m, h;
-
-    if (x == 0) {
-        return 0;
-    } else if (x > (UINT16_MAX >> 2)) {
-        /* Safe upper bound to avoid integer overflow with m * m */
-        h = UINT16_MAX;
-    } else {
-        /* Upper bound based on closest log2 */
-        h = (1 << (((__builtin_clzl(1) - __builtin_clzl(x) + 1) + 1) >> 1));
-    }
-    /* Lower bound based on closest log2 */
-    l = (1 << ((__builtin_clzl(1) - __builtin_clzl(x)) >> 1));
-
-    /* Binary search to find integer square root */
-    while (l != h - 1) {
-        m = (l + h) / 2;
-        if (m * m <= x) {
-            l = m;
-        } else {
-            h = m;
-        }
-    }
-    return l;
-}
-
 cursor_glide_t cursor_glide_start(cursor_glide_context_t* glide) {
     cursor_glide_t         invalid_report = {0, 0, false};
     cursor_glide_status_t* status         = &glide->status;
+    uint32_t               dist_sq        = (uint32_t)((int32_t)status->dx0 * status->dx0) + (uint32_t)((int32_t)status->dy0 * status->dy0);
+    int32_t                v0;
 
-    status->timer   = timer_read();
-    status->counter = 0;
-    status->v0      = (status->dx0 == 0 && status->dy0 == 0) ? 0.0 : sqrt32(((int32_t)status->dx0 * 256 * status->dx0 * 256) + ((int32_t)status->dy0 * 256 * status->dy0 * 256)); // skip trigonometry if not needed, calculate distance in Q8
-    status->x       = 0;
-    status->y       = 0;
-    status->z       = 0;
+    /* Speed of the final movement in Q8, keeping the fraction for slow movements */
+    v0 = dist_sq <= (UINT32_MAX >> 16) ? sqrt32(dist_sq << 16) : (int32_t)sqrt32(dist_sq) << 8;
 
-    if (status->v0 < ((uint32_t)glide->config.trigger_px * 256)) { /* Q8 comparison */
+    status->timer = timer_read();
+    status->x     = 0;
+    status->y     = 0;
+    status->z     = 0;
+
+    if (v0 == 0 || v0 < ((int32_t)glide->config.trigger_px * 256)) { /* Q8 comparison */
         /* Not enough velocity to be worth gliding, abort */
         cursor_glide_stop(glide);
         return invalid_report;
     }
 
+    /*
+     * Friction acts against the direction of movement, split between the axes in proportion to the movement along them.
+     * Done this way instead of applying friction to each axis separately, so we don't end up with the shorter axis stuck at 0 towards the end of diagonal movements.
+     * These are the only divisions, per report the glide only adds.
+     */
+    status->ax = (int32_t)glide->config.coef * status->dx0 * 256 / v0;
+    status->ay = (int32_t)glide->config.coef * status->dy0 * 256 / v0;
+    /* Velocity over the first report, as the friction acts half way through it */
+    status->vx = (int32_t)status->dx0 * 256 - status->ax / 2;
+    status->vy = (int32_t)status->dy0 * 256 - status->ay / 2;
+
     return cursor_glide(glide);
 }
 
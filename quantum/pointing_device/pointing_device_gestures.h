@@ -16,8 +16,67 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "report.h"
 
+/*
+ * Gesture engine shared by the trackpad drivers. Everything here is integer math, trackpads
+ * are commonly paired with MCUs without an FPU, where soft-float would run on every report.
+ */
+
+typedef struct {
+    uint16_t timer;
+    bool     touchDown;
+} trackpad_tap_context_t;
+
+/*
+ * Update tap detection with the latest touch state.
+ * @param touch_down Whether the trackpad reports a touch.
+ * @param contact Whether a finger is in contact, e.g. non-zero pressure. A tap is reported when contact ends in time.
+ * @param tapping_term Longest touch, in milliseconds, that is considered a tap.
+ * @param debounce Time, in milliseconds, after which a touch no longer counts towards a tap.
+ * @return true if a tap was detected.
+ */
+bool trackpad_tap_update(trackpad_tap_context_t* tap, bool touch_down, bool contact, uint16_t tapping_term, uint16_t debounce);
+
+typedef enum {
+    SCROLL_UNINITIALIZED,
+    SCROLL_DETECTING,
+    SCROLL_VALID,
+    NOT_SCROLL,
+} circular_scroll_status_t;
+
+typedef struct {
+    int8_t v;
+    int8_t h;
+    bool   suppress_touch;
+} circular_scroll_t;
+
+typedef struct {
+    uint8_t  outer_ring_pct; /* Width of outer ring, given as a percentage of the radius */
+    uint8_t  trigger_px;     /* Amount of movement before triggering scroll validation, in pixels 0~127 */
+    uint16_t trigger_ang;    /* Angle required to validate scroll, in radians where pi = 32768 */
+    uint8_t  wheel_clicks;   /* How many clicks to report in a circle */
+    bool     left_handed;    /* Whether scrolling should be flipped for left handed use */
+} circular_scroll_config_t;
+
+typedef struct {
+    circular_scroll_config_t config;
+    circular_scroll_status_t state;
+    uint8_t                  mag;
+    int8_t                   x;
+    int8_t                   y;
+    uint16_t                 z;
+    bool                     axis;
+} circular_scroll_context_t;
+
+/*
+ * Update circular scroll with the latest touch position.
+ * @param x, y Touch position relative to the center of the trackpad, scaled to a radius of INT8_MAX and rotated to the keyboard's orientation.
+ * @param z Touch pressure, zero when not touching.
+ */
+circular_scroll_t circular_scroll_update(circular_scroll_context_t* scroll, int8_t x, int8_t y, uint16_t z);
+
 #ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
 typedef struct {
     mouse_xy_report_t dx;
@@ -27,17 +86,19 @@ typedef struct {
 
 typedef struct {
     uint16_t trigger_px; /* Pixels of movement needed to trigger cursor glide */
-    uint16_t coef;       /* Coefficient of friction */
+    uint16_t coef;       /* Coefficient of friction, in 1/256 pixels per report squared */
     uint16_t interval;   /* Glide report interval, in milliseconds */
 } cursor_glide_config_t;
 
 typedef struct {
-    int32_t           v0;
-    int32_t           x;
+    int32_t           x;  /* Position along the glide, Q8 */
     int32_t           y;
+    int32_t           vx; /* Velocity, Q8 pixels per report */
+    int32_t           vy;
+    int32_t           ax; /* Friction per axis, Q8 pixels per report squared */
+    int32_t           ay;
     uint16_t          z;
     uint16_t          timer;
-    uint16_t          counter;
     mouse_xy_report_t dx0;
     mouse_xy_report_t dy0;
 } cursor_glide_status_t;
@@ -0,0 +1,175 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifdef POINTING_DEVICE_SENSOR_COUNT
+
+#    include "pointing_device.h"
+#    include "timer.h"
+
+#    ifdef POINTING_DEVICE_MOTION_PIN
+#        error "POINTING_DEVICE_MOTION_PIN is not supported with a sensor table, set an interval for each sensor instead"
+#    endif
+
+typedef struct {
+    report_mouse_t report;     // last report of the sensor, its buttons are kept between reads
+    int32_t        x, y, h, v; // motion read from the sensor but not yet reported
+    uint32_t       last_read;
+} pointing_device_sensor_state_t;
+
+static pointing_device_sensor_state_t sensor_states[POINTING_DEVICE_SENSOR_COUNT];
+static uint8_t                        last_sensor_buttons = 0;
+
+/**
+ * @brief Weak function allowing for keyboard level modification of a single sensor's report
+ *
+ * Called after each read of the sensor, before its motion is combined with the other sensors, e.g. to rotate one
+ * sensor or to turn the motion of a trackpad into scrolling.
+ *
+ * @param[in] sensor index into pointing_device_sensors
+ * @param[in] sensor_report report_mouse_t
+ * @return report_mouse_t
+ */
+__attribute__((weak)) report_mouse_t pointing_device_task_sensor_kb(uint8_t sensor, report_mouse_t sensor_report) {
+    return pointing_device_task_sensor_user(sensor, sensor_report);
+}
+
+/**
+ * @brief Weak function allowing for user level modification of a single sensor's report
+ *
+ * @param[in] sensor index into pointing_device_sensors
+ * @param[in] sensor_report report_mouse_t
+ * @return report_mouse_t
+ */
+__attribute__((weak)) report_mouse_t pointing_device_task_sensor_user(uint8_t sensor, report_mouse_t sensor_report) {
+    return sensor_report;
+}
+
+/**
+ * @brief Moves as much of `*accumulated` into `total` as stays within [min, max], the rest is kept for the next report
+ */
+static int32_t pointing_device_sensors_take(int32_t *accumulated, int32_t total, int32_t min, int32_t max) {
+    int32_t taken = *accumulated;
+    if (total + taken > max) {
+        taken = max - total;
+    } else if (total + taken < min) {
+        taken = min - total;
+    }
+    *accumulated -= taken;
+    return total + taken;
+}
+
+static void pointing_device_sensors_init(void) {
+    uint32_t now = timer_read32();
+    for (uint8_t i = 0; i < POINTING_DEVICE_SENSOR_COUNT; i++) {
+        if (pointing_device_sensors[i].driver->init) {
+            pointing_device_sensors[i].driver->init();
+        }
+        // Every sensor is read on the first task
+        sensor_states[i] = (pointing_device_sensor_state_t){.last_read = now - pointing_device_sensors[i].interval};
+    }
+    last_sensor_buttons = 0;
+}
+
+/**
+ * @brief Reads the sensors which are due and combines the motion of all sensors into `mouse_report`
+ *
+ * Each sensor has its own accumulator, so motion that does not fit into the combined report stays with the sensor it
+ * came from until the next report. Buttons pressed on any sensor are pressed in the combined report, and only buttons
+ * changed by the sensors since the last call are applied, so buttons set from the keymap are kept.
+ */
+static report_mouse_t pointing_device_sensors_get_report(report_mouse_t mouse_report) {
+    uint32_t now            = timer_read32();
+    uint8_t  sensor_buttons = 0;
+
+    for (uint8_t i = 0; i < POINTING_DEVICE_SENSOR_COUNT; i++) {
+        const pointing_device_sensor_t *sensor = &pointing_device_sensors[i];
+        pointing_device_sensor_state_t *state  = &sensor_states[i];
+
+        if (TIMER_DIFF_32(now, state->last_read) >= sensor->interval) {
+            state->last_read = now;
+            state->report.x  = 0;
+            state->report.y  = 0;
+            state->report.h  = 0;
+            state->report.v  = 0;
+            state->report    = sensor->driver->get_report(state->report);
+            state->report    = pointing_device_task_sensor_kb(i, state->report);
+            state->x += state->report.x;
+            state->y += state->report.y;
+            state->h += state->report.h;
+            state->v += state->report.v;
+        }
+        sensor_buttons |= state->report.buttons;
+    }
+
+    int32_t x = 0, y = 0, h = 0, v = 0;
+    for (uint8_t i = 0; i < POINTING_DEVICE_SENSOR_COUNT; i++) {
+        pointing_device_sensor_state_t *state = &sensor_states[i];
+
+        x = pointing_device_sensors_take(&state->x, x, XY_REPORT_MIN, XY_REPORT_MAX);
+        y = pointing_device_sensors_take(&state->y, y, XY_REPORT_MIN, XY_REPORT_MAX);
+        h = pointing_device_sensors_take(&state->h, h, INT8_MIN, INT8_MAX);
+        v = pointing_device_sensors_take(&state->v, v, INT8_MIN, INT8_MAX);
+    }
+    mouse_report.x = x;
+    mouse_report.y = y;
+    mouse_report.h = h;
+    mouse_report.v = v;
+
+    uint8_t changed      = sensor_buttons ^ last_sensor_buttons;
+    mouse_report.buttons = (mouse_report.buttons & ~changed) | (sensor_buttons & changed);
+    last_sensor_buttons  = sensor_buttons;
+    return mouse_report;
+}
+
+/**
+ * @brief Gets the CPI of a single sensor
+ *
+ * @param[in] sensor index into pointing_device_sensors
+ * @return uint16_t CPI, or 0 if the sensor has no CPI setting
+ */
+uint16_t pointing_device_get_sensor_cpi(uint8_t sensor) {
+    if (sensor >= POINTING_DEVICE_SENSOR_COUNT || !pointing_device_sensors[sensor].driver->get_cpi) {
+        return 0;
+    }
+    return pointing_device_sensors[sensor].driver->get_cpi();
+}
+
+/**
+ * @brief Sets the CPI of a single sensor
+ *
+ * @param[in] sensor index into pointing_device_sensors
+ * @param[in] cpi uint16_t value
+ */
+void pointing_device_set_sensor_cpi(uint8_t sensor, uint16_t cpi) {
+    if (sensor >= POINTING_DEVICE_SENSOR_COUNT || !pointing_device_sensors[sensor].driver->set_cpi) {
+        return;
+    }
+    pointing_device_sensors[sensor].driver->set_cpi(cpi);
+}
+
+/**
+ * @brief The CPI of the combined sensors is that of the first sensor
+ */
+static uint16_t pointing_device_sensors_get_cpi(void) {
+    return pointing_device_get_sensor_cpi(0);
+}
+
+/**
+ * @brief Sets the CPI of every sensor, use pointing_device_set_sensor_cpi() to set them individually
+ */
+static void pointing_device_sensors_set_cpi(uint16_t cpi) {
+    for (uint8_t i = 0; i < POINTING_DEVICE_SENSOR_COUNT; i++) {
+        pointing_device_set_sensor_cpi(i, cpi);
+    }
+}
+
+// clang-format off
+const pointing_device_driver_t pointing_device_driver = {
+    .init       = pointing_device_sensors_init,
+    .get_report = pointing_device_sensors_get_report,
+    .set_cpi    = pointing_device_sensors_set_cpi,
+    .get_cpi    = pointing_device_sensors_get_cpi
+};
+// clang-format on
+
+#endif
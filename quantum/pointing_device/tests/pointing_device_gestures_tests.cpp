@@ -0,0 +1,331 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "pointing_device_gestures.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+/* One sample from the trackpad, as the driver sees it on each report */
+struct TouchSample {
+    uint16_t time;
+    int16_t  x; // absolute position relative to the center for taps and scrolling, movement for glides
+    int16_t  y;
+    uint16_t z;
+};
+
+struct Movement {
+    int32_t dx;
+    int32_t dy;
+};
+
+#define TAPPING_TERM 200
+#define TOUCH_DEBOUNCE (TAPPING_TERM * 8)
+#define REPORT_INTERVAL 10
+
+class PointingDeviceGestures : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+    }
+
+    /* Replays a trace through tap detection, returns the number of taps */
+    int replay_taps(const std::vector<TouchSample>& trace) {
+        trackpad_tap_context_t tap   = {};
+        int                    taps  = 0;
+        uint16_t               start = 1000;
+        set_time(start);
+        for (const TouchSample& sample : trace) {
+            set_time(start + sample.time);
+            if (trackpad_tap_update(&tap, sample.z != 0, sample.z != 0, TAPPING_TERM, TOUCH_DEBOUNCE)) {
+                taps++;
+            }
+        }
+        return taps;
+    }
+
+    /* Replays a trace through circular scroll, returns the sum of the scroll reports */
+    circular_scroll_t replay_scroll(circular_scroll_context_t* scroll, const std::vector<TouchSample>& trace) {
+        circular_scroll_t total = {0, 0, false};
+        for (const TouchSample& sample : trace) {
+            circular_scroll_t report = circular_scroll_update(scroll, sample.x, sample.y, sample.z);
+            total.v += report.v;
+            total.h += report.h;
+            total.suppress_touch = report.suppress_touch;
+        }
+        return total;
+    }
+
+    /* Replays cursor movement through cursor glide the way the trackpad drivers do, returns the glide reports after lift off */
+    std::vector<Movement> replay_glide(cursor_glide_context_t* glide, const std::vector<TouchSample>& trace) {
+        std::vector<Movement> reports;
+        uint16_t              start = 1000;
+        uint16_t              now   = start;
+
+        for (const TouchSample& sample : trace) {
+            now = start + sample.time;
+            set_time(now);
+            cursor_glide_t glide_report = cursor_glide_check(glide);
+            if (sample.z) {
+                cursor_glide_update(glide, sample.x, sample.y, sample.z);
+            } else {
+                if (glide->status.z) {
+                    glide_report = cursor_glide_start(glide);
+                }
+                if (glide_report.valid) {
+                    reports.push_back({glide_report.dx, glide_report.dy});
+                }
+            }
+        }
+        /* Keep polling after the trace until the glide comes to rest */
+        for (int i = 0; i < 1000 && (glide->status.dx0 || glide->status.dy0); i++) {
+            now += REPORT_INTERVAL;
+            set_time(now);
+            cursor_glide_t glide_report = cursor_glide_check(glide);
+            if (glide_report.valid) {
+                reports.push_back({glide_report.dx, glide_report.dy});
+            }
+        }
+        return reports;
+    }
+
+    cursor_glide_context_t make_glide(uint16_t trigger_px) {
+        cursor_glide_context_t glide = {};
+        glide.config.coef            = 102;
+        glide.config.interval        = REPORT_INTERVAL;
+        glide.config.trigger_px      = trigger_px;
+        return glide;
+    }
+
+    circular_scroll_context_t make_scroll(void) {
+        circular_scroll_context_t scroll = {};
+        scroll.config.outer_ring_pct     = 33;
+        scroll.config.trigger_px         = 16;
+        scroll.config.trigger_ang        = 9102;
+        scroll.config.wheel_clicks       = 18;
+        return scroll;
+    }
+
+    /* A finger going once around the outer ring, counter clockwise from the right hand side, sampled every 2 degrees */
+    std::vector<TouchSample> circle_trace(void) {
+        std::vector<TouchSample> trace;
+        for (int i = 0; i <= 180; i++) {
+            double angle = i * 2 * M_PI / 180;
+            trace.push_back({(uint16_t)(i * REPORT_INTERVAL), (int16_t)std::lround(110 * std::cos(angle)), (int16_t)std::lround(110 * std::sin(angle)), 40});
+        }
+        trace.push_back({(uint16_t)(181 * REPORT_INTERVAL), 0, 0, 0});
+        return trace;
+    }
+};
+
+TEST_F(PointingDeviceGestures, QuickTouchIsTap) {
+    std::vector<TouchSample> trace = {
+        {0, 0, 0, 0},
+        {10, 0, 0, 35},
+        {20, 0, 0, 42},
+        {90, 0, 0, 38},
+        {100, 0, 0, 0},
+    };
+    EXPECT_EQ(replay_taps(trace), 1);
+}
+
+TEST_F(PointingDeviceGestures, LongTouchIsNotTap) {
+    std::vector<TouchSample> trace = {
+        {0, 0, 0, 0},
+        {10, 0, 0, 35},
+        {150, 0, 0, 40},
+        {10 + TAPPING_TERM + 10, 0, 0, 0},
+    };
+    EXPECT_EQ(replay_taps(trace), 0);
+}
+
+TEST_F(PointingDeviceGestures, TwoQuickTouchesAreTwoTaps) {
+    std::vector<TouchSample> trace = {
+        {0, 0, 0, 0}, {10, 0, 0, 30}, {60, 0, 0, 0}, {150, 0, 0, 30}, {210, 0, 0, 0},
+    };
+    EXPECT_EQ(replay_taps(trace), 2);
+}
+
+TEST_F(PointingDeviceGestures, CircleAroundOuterRingScrolls) {
+    circular_scroll_context_t scroll = make_scroll();
+    circular_scroll_t         total  = replay_scroll(&scroll, circle_trace());
+
+    /*
+     * Started on the right hand side, so scrolls vertically. About one turn of the wheel: the remainder
+     * is dropped with every click, and the integer atan2 reads small steps as slightly larger angles.
+     */
+    EXPECT_LE((int)total.v, -14);
+    EXPECT_GE((int)total.v, -22);
+    EXPECT_EQ((int)total.h, 0);
+    EXPECT_EQ(scroll.state, SCROLL_UNINITIALIZED);
+}
+
+TEST_F(PointingDeviceGestures, CircleFromLeftHalfScrollsHorizontally) {
+    circular_scroll_context_t scroll = make_scroll();
+    std::vector<TouchSample>  trace  = circle_trace();
+    for (TouchSample& sample : trace) {
+        sample.x = -sample.x;
+    }
+    circular_scroll_t total = replay_scroll(&scroll, trace);
+
+    /* Mirrored, so the circle is now clockwise */
+    EXPECT_LE((int)total.h, -14);
+    EXPECT_GE((int)total.h, -22);
+    EXPECT_EQ((int)total.v, 0);
+}
+
+TEST_F(PointingDeviceGestures, MovementTowardsCenterIsNotScroll) {
+    circular_scroll_context_t scroll = make_scroll();
+    std::vector<TouchSample>  trace  = {
+        {0, 110, 0, 40},
+        {10, 100, 2, 40},
+        {20, 88, 3, 40},
+    };
+    circular_scroll_t total = replay_scroll(&scroll, trace);
+
+    EXPECT_EQ(scroll.state, NOT_SCROLL);
+    EXPECT_FALSE(total.suppress_touch);
+    EXPECT_EQ((int)total.v, 0);
+    EXPECT_EQ((int)total.h, 0);
+}
+
+TEST_F(PointingDeviceGestures, TouchInsideRingIsNotScroll) {
+    circular_scroll_context_t scroll = make_scroll();
+    std::vector<TouchSample>  trace  = {
+        {0, 20, 10, 40},
+        {10, 30, 40, 40},
+        {20, 10, 70, 40},
+    };
+    circular_scroll_t total = replay_scroll(&scroll, trace);
+
+    EXPECT_EQ(scroll.state, SCROLL_UNINITIALIZED);
+    EXPECT_FALSE(total.suppress_touch);
+}
+
+TEST_F(PointingDeviceGestures, JumpAcrossPadIsMovement) {
+    circular_scroll_context_t scroll = make_scroll();
+    /* The squared distance of this jump does not fit in 16 bits */
+    std::vector<TouchSample> trace = {
+        {0, 100, 80, 40},
+        {10, -100, -80, 40},
+    };
+    circular_scroll_t total = replay_scroll(&scroll, trace);
+
+    EXPECT_EQ(scroll.state, NOT_SCROLL);
+    EXPECT_FALSE(total.suppress_touch);
+}
+
+/* The glide as it was calculated before it was made incremental, with a division per axis on every report */
+static std::vector<Movement> reference_glide(int32_t dx0, int32_t dy0, int32_t coef) {
+    std::vector<Movement> reports;
+    int32_t               v0 = std::lround(std::sqrt((double)(dx0 * dx0 + dy0 * dy0)) * 256);
+    int32_t               x = 0, y = 0;
+
+    for (int32_t n = 1; n < 1000; n++) {
+        int32_t p  = v0 * n - coef * n * n / 2;
+        int32_t nx = p * dx0 / v0;
+        int32_t ny = p * dy0 / v0;
+        reports.push_back({nx - x, ny - y});
+        if (std::abs(nx - x) <= 1 && std::abs(ny - y) <= 1) {
+            break;
+        }
+        x = nx;
+        y = ny;
+    }
+    return reports;
+}
+
+static Movement total_movement(const std::vector<Movement>& reports) {
+    Movement total = {0, 0};
+    for (const Movement& report : reports) {
+        total.dx += report.dx;
+        total.dy += report.dy;
+    }
+    return total;
+}
+
+TEST_F(PointingDeviceGestures, FlickGlides) {
+    cursor_glide_context_t   glide = make_glide(10);
+    std::vector<TouchSample> trace = {
+        {0, 2, 0, 40}, {10, 8, 1, 42}, {20, 15, 0, 45}, {30, 20, 0, 40}, {40, 0, 0, 0},
+    };
+    std::vector<Movement> reports   = replay_glide(&glide, trace);
+    std::vector<Movement> reference = reference_glide(20, 0, 102);
+
+    /* Rounding may end the glide one report earlier or later */
+    ASSERT_NEAR(reports.size(), reference.size(), 1);
+    for (size_t i = 0; i < std::min(reports.size(), reference.size()); i++) {
+        EXPECT_NEAR(reports[i].dx, reference[i].dx, 1) << "report " << i;
+        EXPECT_EQ(reports[i].dy, 0) << "report " << i;
+    }
+    /* Slows down steadily, apart from the fractions carried between reports */
+    for (size_t i = 1; i < reports.size(); i++) {
+        EXPECT_LE(reports[i].dx, reports[i - 1].dx + 1) << "report " << i;
+    }
+    EXPECT_NEAR(total_movement(reports).dx, total_movement(reference).dx, 2);
+}
+
+TEST_F(PointingDeviceGestures, DiagonalFlickKeepsDirection) {
+    cursor_glide_context_t   glide = make_glide(10);
+    std::vector<TouchSample> trace = {
+        {0, -6, 2, 40},
+        {10, -12, 5, 40},
+        {20, 0, 0, 0},
+    };
+    std::vector<Movement> reports   = replay_glide(&glide, trace);
+    std::vector<Movement> reference = reference_glide(-12, 5, 102);
+
+    ASSERT_NEAR(reports.size(), reference.size(), 1);
+    for (size_t i = 0; i < std::min(reports.size(), reference.size()); i++) {
+        EXPECT_NEAR(reports[i].dx, reference[i].dx, 1) << "report " << i;
+        EXPECT_NEAR(reports[i].dy, reference[i].dy, 1) << "report " << i;
+    }
+    Movement total = total_movement(reports);
+    EXPECT_LT(total.dx, 0);
+    EXPECT_GT(total.dy, 0);
+    /* The shorter axis keeps moving for as long as the longer one */
+    EXPECT_NEAR((double)total.dy / total.dx, 5.0 / -12.0, 0.05);
+}
+
+TEST_F(PointingDeviceGestures, SlowLiftDoesNotGlide) {
+    cursor_glide_context_t   glide = make_glide(10);
+    std::vector<TouchSample> trace = {
+        {0, 6, 0, 40},
+        {10, 3, 4, 40},
+        {20, 0, 0, 0},
+    };
+    EXPECT_TRUE(replay_glide(&glide, trace).empty());
+}
+
+TEST_F(PointingDeviceGestures, GlideFollowsInterval) {
+    cursor_glide_context_t glide = make_glide(0);
+
+    cursor_glide_update(&glide, 30, 0, 40);
+    cursor_glide_t report = cursor_glide_start(&glide);
+    EXPECT_TRUE(report.valid);
+
+    advance_time(REPORT_INTERVAL - 1);
+    EXPECT_FALSE(cursor_glide_check(&glide).valid);
+    advance_time(1);
+    EXPECT_TRUE(cursor_glide_check(&glide).valid);
+}
+
+TEST_F(PointingDeviceGestures, TouchStopsGlide) {
+    cursor_glide_context_t glide = make_glide(0);
+
+    cursor_glide_update(&glide, 30, 0, 40);
+    EXPECT_TRUE(cursor_glide_start(&glide).valid);
+
+    cursor_glide_update(&glide, 1, 0, 40);
+    advance_time(REPORT_INTERVAL);
+    EXPECT_FALSE(cursor_glide_check(&glide).valid);
+}
@@ -0,0 +1,232 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <deque>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "pointing_device.h"
+
+extern const pointing_device_driver_t pointing_device_driver;
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define TRACKPAD_INTERVAL 10
+
+/* A sensor which returns queued reports, and no motion once the queue is empty */
+struct FakeSensor {
+    int                        inits   = 0;
+    int                        reads   = 0;
+    uint16_t                   cpi     = 0;
+    uint8_t                    buttons = 0;
+    std::deque<report_mouse_t> reports;
+
+    void push(mouse_xy_report_t x, mouse_xy_report_t y, int8_t h = 0, int8_t v = 0) {
+        report_mouse_t report = {};
+        report.x              = x;
+        report.y              = y;
+        report.h              = h;
+        report.v              = v;
+        reports.push_back(report);
+    }
+};
+
+static FakeSensor sensors[POINTING_DEVICE_SENSOR_COUNT];
+
+template <int N>
+static void fake_init(void) {
+    sensors[N].inits++;
+}
+
+template <int N>
+static report_mouse_t fake_get_report(report_mouse_t mouse_report) {
+    sensors[N].reads++;
+    if (!sensors[N].reports.empty()) {
+        report_mouse_t next = sensors[N].reports.front();
+        sensors[N].reports.pop_front();
+        mouse_report.x = next.x;
+        mouse_report.y = next.y;
+        mouse_report.h = next.h;
+        mouse_report.v = next.v;
+    }
+    mouse_report.buttons = sensors[N].buttons;
+    return mouse_report;
+}
+
+template <int N>
+static uint16_t fake_get_cpi(void) {
+    return sensors[N].cpi;
+}
+
+template <int N>
+static void fake_set_cpi(uint16_t cpi) {
+    sensors[N].cpi = cpi;
+}
+
+static const pointing_device_driver_t trackball_driver = {fake_init<0>, fake_get_report<0>, fake_set_cpi<0>, fake_get_cpi<0>};
+static const pointing_device_driver_t trackpad_driver  = {fake_init<1>, fake_get_report<1>, fake_set_cpi<1>, fake_get_cpi<1>};
+static const pointing_device_driver_t joystick_driver  = {NULL, fake_get_report<2>, NULL, NULL};
+
+extern "C" const pointing_device_sensor_t pointing_device_sensors[POINTING_DEVICE_SENSOR_COUNT] = {
+    {&trackball_driver, 0},
+    {&trackpad_driver, TRACKPAD_INTERVAL},
+    {&joystick_driver, 0},
+};
+
+/* Turns the trackpad's motion into scrolling, as a keymap would with pointing_device_task_sensor_user() */
+static bool trackpad_scrolls = false;
+
+extern "C" report_mouse_t pointing_device_task_sensor_user(uint8_t sensor, report_mouse_t sensor_report) {
+    if (sensor == 1 && trackpad_scrolls) {
+        sensor_report.h = sensor_report.x;
+        sensor_report.v = sensor_report.y;
+        sensor_report.x = 0;
+        sensor_report.y = 0;
+    }
+    return sensor_report;
+}
+
+class PointingDeviceSensors : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        for (FakeSensor& sensor : sensors) {
+            sensor = FakeSensor();
+        }
+        trackpad_scrolls = false;
+        set_time(1000);
+        pointing_device_driver.init();
+    }
+
+    /* Runs one pointing device task, one millisecond apart */
+    report_mouse_t task(report_mouse_t mouse_report = {}) {
+        report_mouse_t report = pointing_device_driver.get_report(mouse_report);
+        advance_time(1);
+        return report;
+    }
+};
+
+TEST_F(PointingDeviceSensors, InitialisesEverySensor) {
+    EXPECT_EQ(sensors[0].inits, 1);
+    EXPECT_EQ(sensors[1].inits, 1);
+}
+
+TEST_F(PointingDeviceSensors, SensorsAreReadAtTheirOwnInterval) {
+    for (int i = 0; i < 100; i++) {
+        task();
+    }
+    EXPECT_EQ(sensors[0].reads, 100);
+    EXPECT_EQ(sensors[1].reads, 100 / TRACKPAD_INTERVAL);
+    EXPECT_EQ(sensors[2].reads, 100);
+}
+
+TEST_F(PointingDeviceSensors, MotionOfAllSensorsIsCombined) {
+    sensors[0].push(10, -5);
+    sensors[1].push(3, 4, 0, 1);
+    sensors[2].push(-1, 0, 2, 0);
+
+    report_mouse_t report = task();
+    EXPECT_EQ(report.x, 12);
+    EXPECT_EQ(report.y, -1);
+    EXPECT_EQ(report.h, 2);
+    EXPECT_EQ(report.v, 1);
+
+    // Nothing is reported twice
+    report = task();
+    EXPECT_EQ(report.x, 0);
+    EXPECT_EQ(report.y, 0);
+    EXPECT_EQ(report.h, 0);
+    EXPECT_EQ(report.v, 0);
+}
+
+TEST_F(PointingDeviceSensors, MotionBeyondOneReportIsCarriedOver) {
+    sensors[0].push(XY_REPORT_MAX, 0, 0, 100);
+    sensors[2].push(XY_REPORT_MAX, 0, 0, 100);
+
+    report_mouse_t report = task();
+    EXPECT_EQ(report.x, XY_REPORT_MAX);
+    EXPECT_EQ(report.v, INT8_MAX);
+
+    int32_t x = report.x, v = report.v;
+    for (int i = 0; i < 3; i++) {
+        report = task();
+        x += report.x;
+        v += report.v;
+    }
+    EXPECT_EQ(x, 2 * XY_REPORT_MAX);
+    EXPECT_EQ(v, 200);
+}
+
+TEST_F(PointingDeviceSensors, OpposingMotionCancelsOut) {
+    sensors[0].push(XY_REPORT_MAX, 0);
+    sensors[2].push(-XY_REPORT_MAX, 0);
+    report_mouse_t report = task();
+    EXPECT_EQ(report.x, 0);
+
+    report = task();
+    EXPECT_EQ(report.x, 0);
+}
+
+TEST_F(PointingDeviceSensors, ButtonsOfAnySensorArePressed) {
+    sensors[1].buttons    = 0x01;
+    report_mouse_t report = task();
+    EXPECT_EQ(report.buttons, 0x01);
+
+    sensors[0].buttons = 0x02;
+    report             = task(report);
+    EXPECT_EQ(report.buttons, 0x03);
+
+    // The trackpad is not read again until its interval has passed
+    sensors[1].buttons = 0x00;
+    report             = task(report);
+    EXPECT_EQ(report.buttons, 0x03);
+    advance_time(TRACKPAD_INTERVAL);
+    report = task(report);
+    EXPECT_EQ(report.buttons, 0x02);
+}
+
+TEST_F(PointingDeviceSensors, ButtonsFromTheKeymapAreKept) {
+    report_mouse_t report = task();
+    report.buttons        = 0x04;
+    report                = task(report);
+    EXPECT_EQ(report.buttons, 0x04);
+
+    sensors[0].buttons = 0x01;
+    report             = task(report);
+    EXPECT_EQ(report.buttons, 0x05);
+
+    sensors[0].buttons = 0x00;
+    report             = task(report);
+    EXPECT_EQ(report.buttons, 0x04);
+}
+
+TEST_F(PointingDeviceSensors, SensorReportsCanBeModifiedIndividually) {
+    trackpad_scrolls = true;
+    sensors[0].push(5, 6);
+    sensors[1].push(3, -2);
+
+    report_mouse_t report = task();
+    EXPECT_EQ(report.x, 5);
+    EXPECT_EQ(report.y, 6);
+    EXPECT_EQ(report.h, 3);
+    EXPECT_EQ(report.v, -2);
+}
+
+TEST_F(PointingDeviceSensors, CpiIsSetPerSensor) {
+    pointing_device_driver.set_cpi(800);
+    EXPECT_EQ(sensors[0].cpi, 800);
+    EXPECT_EQ(sensors[1].cpi, 800);
+
+    pointing_device_set_sensor_cpi(1, 1200);
+    EXPECT_EQ(pointing_device_get_sensor_cpi(0), 800);
+    EXPECT_EQ(pointing_device_get_sensor_cpi(1), 1200);
+    EXPECT_EQ(pointing_device_driver.get_cpi(), 800);
+
+    // Sensors without a CPI setting, and sensors not in the table, are ignored
+    pointing_device_set_sensor_cpi(2, 400);
+    pointing_device_set_sensor_cpi(POINTING_DEVICE_SENSOR_COUNT, 400);
+    EXPECT_EQ(pointing_device_get_sensor_cpi(2), 0);
+    EXPECT_EQ(pointing_device_get_sensor_cpi(POINTING_DEVICE_SENSOR_COUNT), 0);
+}
@@ -0,0 +1,22 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+pointing_device_gestures_DEFS := -DNO_DEBUG -DPOINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+
+pointing_device_gestures_INC := \
+	$(QUANTUM_PATH)/pointing_device
+
+pointing_device_gestures_SRC := \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_gestures_tests.cpp \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_gestures.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+pointing_device_sensors_DEFS := -DNO_DEBUG -DPOINTING_DEVICE_SENSOR_COUNT=3
+
+pointing_device_sensors_INC := \
+	$(QUANTUM_PATH)/pointing_device
+
+pointing_device_sensors_SRC := \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_sensors_tests.cpp \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_sensors.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
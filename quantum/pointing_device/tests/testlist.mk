@@ -0,0 +1,2 @@
+TEST_LIST += pointing_device_gestures
+TEST_LIST += pointing_device_sensors
@@ -248,9 +248,8 @@ bool process_midi(uint16_t keycode, keyrecord_t *record) {
 
 #endif // MIDI_ADVANCED
 
-void midi_task(void) {
-    midi_device_process(&midi_device);
 #ifdef MIDI_ADVANCED
+static void midi_modulation_task(void) {
     if (timer_elapsed(midi_modulation_timer) < midi_config.modulation_interval) return;
     midi_modulation_timer = timer_read();
 
@@ -268,5 +267,14 @@ void midi_task(void) {
 
         if (midi_modulation > 127) midi_modulation = 127;
     }
+}
+#endif
+
+void midi_task(void) {
+    midi_device_process(&midi_device);
+#ifdef MIDI_ADVANCED
+    midi_modulation_task();
 #endif
+    // everything sent during this loop goes out together
+    flush_midi_packets();
 }
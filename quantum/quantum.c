@@ -24,6 +24,10 @@
 #    include "outputselect.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef GRAVE_ESC_ENABLE
 #    include "process_grave_esc.h"
 #endif
@@ -194,6 +198,9 @@ void shutdown_quantum(bool jump_to_bootloader) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
+#endif
 }
 
 void reset_keyboard(void) {
@@ -292,7 +299,7 @@ bool process_record_quantum(keyrecord_t *record) {
 
 #ifdef WPM_ENABLE
     if (record->event.pressed) {
-        update_wpm(keycode);
+        update_wpm_key(keycode, record->event.key);
     }
 #endif
 
@@ -113,6 +113,11 @@ static bool pre_suspend_enabled;
 
 #ifdef RGBLIGHT_USE_TIMER
 animation_status_t animation_status = {};
+
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+// Set when the animation timer expires, the main loop only looks at the animation while a frame is due
+static volatile bool animation_frame_due = true;
+#    endif
 #endif
 
 #ifndef LED_ARRAY
@@ -141,6 +146,30 @@ void rgblight_set_effect_range(uint8_t start_pos, uint8_t num_leds) {
     rgblight_ranges.effect_num_leds  = num_leds;
 }
 
+#if defined(RGBLIGHT_EFFECT_RAINBOW_SWIRL) || defined(RGBLIGHT_EFFECT_STATIC_GRADIENT)
+static uint8_t  hue_offsets[RGBLED_NUM];
+static uint8_t  hue_offsets_num_leds = 0;
+static uint16_t hue_offsets_range    = 0;
+static bool     hue_offsets_stepped  = false;
+
+/* Hue offset of each LED across the effect range, spreading `range` over the LEDs either
+ * as a whole (gradient) or in equal integer steps (swirl). Only recalculated when the
+ * number of LEDs in the effect range or the spread changes, not on every frame. A range
+ * above 255 wraps around the hue wheel, as the per-LED calculation it replaces did. */
+static const uint8_t *get_hue_offsets(uint16_t range, bool stepped) {
+    uint8_t num_leds = rgblight_ranges.effect_num_leds;
+    if (num_leds != hue_offsets_num_leds || range != hue_offsets_range || stepped != hue_offsets_stepped) {
+        for (uint8_t i = 0; i < num_leds; i++) {
+            hue_offsets[i] = stepped ? range / num_leds * i : ((uint32_t)i * range) / num_leds;
+        }
+        hue_offsets_num_leds = num_leds;
+        hue_offsets_range    = range;
+        hue_offsets_stepped  = stepped;
+    }
+    return hue_offsets;
+}
+#endif
+
 __attribute__((weak)) RGB rgblight_hsv_to_rgb(HSV hsv) {
     return hsv_to_rgb(hsv);
 }
@@ -570,9 +599,10 @@ void rgblight_sethsv_eeprom_helper(uint8_t hue, uint8_t sat, uint8_t val, bool w
                 uint8_t delta     = rgblight_config.mode - rgblight_status.base_mode;
                 bool    direction = (delta % 2) == 0;
 
-                uint8_t range = pgm_read_byte(&RGBLED_GRADIENT_RANGES[delta / 2]);
+                uint8_t        range   = pgm_read_byte(&RGBLED_GRADIENT_RANGES[delta / 2]);
+                const uint8_t *offsets = get_hue_offsets(range, false);
                 for (uint8_t i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-                    uint8_t _hue = ((uint16_t)i * (uint16_t)range) / rgblight_ranges.effect_num_leds;
+                    uint8_t _hue = offsets[i];
                     if (direction) {
                         _hue = hue + _hue;
                     } else {
@@ -614,6 +644,15 @@ uint8_t rgblight_get_speed(void) {
 }
 
 void rgblight_set_speed_eeprom_helper(uint8_t speed, bool write_to_eeprom) {
+#ifdef RGBLIGHT_USE_TIMER
+    if (speed != rgblight_config.speed) {
+        // The pending step was timed at the previous speed, so draw the next one now and time the following ones at the new speed
+        animation_status.last_timer = sync_timer_read();
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+        animation_frame_due = true;
+#    endif
+    }
+#endif
     rgblight_config.speed = speed;
     if (write_to_eeprom) {
         eeconfig_update_rgblight(rgblight_config.raw);
@@ -900,6 +939,63 @@ void rgblight_wakeup(void) {
 
 #endif
 
+#ifdef RGBLIGHT_USE_TIMER
+static bool last_frame_valid = false;
+static bool in_effect_frame  = false;
+
+#    if defined(RGBLIGHT_EFFECT_BREATHING) || defined(RGBLIGHT_EFFECT_CHRISTMAS)
+// Everything an animation frame is drawn from, to skip frames which would not change any LED
+typedef struct {
+    uint8_t mode;
+    uint8_t hue;
+    uint8_t sat;
+    uint8_t val;
+    uint8_t phase_hue;
+    uint8_t phase_val;
+    uint8_t effect_start_pos;
+    uint8_t effect_num_leds;
+    uint8_t clipping_start_pos;
+    uint8_t clipping_num_leds;
+#        ifdef RGBLIGHT_LAYERS
+    rgblight_layer_mask_t enabled_layer_mask;
+#        endif
+} rgblight_frame_t;
+
+static rgblight_frame_t last_frame;
+
+/* Returns true when the frame an effect is about to draw is identical to the last one
+ * drawn, so the LEDs are already showing it. Any rgblight_set() outside of an animation
+ * frame, e.g. from rgblight_setrgb_at(), means the LEDs may no longer match. */
+static bool rgblight_frame_unchanged(uint8_t phase_hue, uint8_t phase_val) {
+    rgblight_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.mode               = rgblight_config.mode;
+    frame.hue                = rgblight_config.hue;
+    frame.sat                = rgblight_config.sat;
+    frame.val                = rgblight_config.val;
+    frame.phase_hue          = phase_hue;
+    frame.phase_val          = phase_val;
+    frame.effect_start_pos   = rgblight_ranges.effect_start_pos;
+    frame.effect_num_leds    = rgblight_ranges.effect_num_leds;
+    frame.clipping_start_pos = rgblight_ranges.clipping_start_pos;
+    frame.clipping_num_leds  = rgblight_ranges.clipping_num_leds;
+#        ifdef RGBLIGHT_LAYERS
+    frame.enabled_layer_mask = rgblight_status.enabled_layer_mask;
+#        endif
+
+    // A custom rgblight_set() does not tell us about changes made outside of the animation, so every frame is drawn
+#        ifndef RGBLIGHT_CUSTOM
+    if (last_frame_valid && memcmp(&frame, &last_frame, sizeof(frame)) == 0) {
+        return true;
+    }
+#        endif
+    last_frame       = frame;
+    last_frame_valid = true;
+    return false;
+}
+#    endif
+#endif
+
 __attribute__((weak)) void rgblight_call_driver(rgb_led_t *start_led, uint8_t num_leds) {
     ws2812_setleds(start_led, num_leds);
 }
@@ -910,6 +1006,12 @@ void rgblight_set(void) {
     rgb_led_t *start_led;
     uint8_t    num_leds = rgblight_ranges.clipping_num_leds;
 
+#    ifdef RGBLIGHT_USE_TIMER
+    if (!in_effect_frame) {
+        last_frame_valid = false;
+    }
+#    endif
+
     if (!rgblight_config.enable) {
         for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
             led[i].r = 0;
@@ -935,7 +1037,8 @@ void rgblight_set(void) {
 
 #    ifdef RGBLIGHT_LED_MAP
     rgb_led_t led0[RGBLED_NUM];
-    for (uint8_t i = 0; i < RGBLED_NUM; i++) {
+    // only the LEDs within the clipping range are sent
+    for (uint8_t i = rgblight_ranges.clipping_start_pos; i < rgblight_ranges.clipping_start_pos + num_leds; i++) {
         led0[i] = led[pgm_read_byte(&led_map[i])];
     }
     start_led = led0 + rgblight_ranges.clipping_start_pos;
@@ -997,6 +1100,9 @@ void rgblight_update_sync(rgblight_syncinfo_t *syncinfo, bool write_to_eeprom) {
 #        ifndef RGBLIGHT_SPLIT_NO_ANIMATION_SYNC
     if (syncinfo->status.change_flags & RGBLIGHT_STATUS_ANIMATION_TICK) {
         animation_status.restart = true;
+#            ifdef RGBLIGHT_ANIMATION_TIMER
+        animation_frame_due = true;
+#            endif
     }
 #        endif /* RGBLIGHT_SPLIT_NO_ANIMATION_SYNC */
 #    endif     /* RGBLIGHT_USE_TIMER */
@@ -1007,16 +1113,37 @@ void rgblight_update_sync(rgblight_syncinfo_t *syncinfo, bool write_to_eeprom) {
 
 typedef void (*effect_func_t)(animation_status_t *anim);
 
-// Animation timer -- use system timer (AVR Timer0)
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+// Without a timer backend on this platform every main loop iteration looks at the animation, as without RGBLIGHT_ANIMATION_TIMER
+__attribute__((weak)) void rgblight_animation_timer_init(void) {}
+
+__attribute__((weak)) void rgblight_animation_timer_schedule(uint16_t delay_ms) {
+    rgblight_animation_timer_expired();
+}
+
+void rgblight_animation_timer_expired(void) {
+    animation_frame_due = true;
+}
+#    endif
+
+// Animation timer -- frames are timed against the (split synchronised) system timer. With RGBLIGHT_ANIMATION_TIMER
+// a platform timer wakes the animation when the next frame is due, otherwise it is checked on every rgblight_task().
 void rgblight_timer_init(void) {
     rgblight_status.timer_enabled = false;
     RGBLIGHT_SPLIT_SET_CHANGE_TIMER_ENABLE;
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+    rgblight_animation_timer_init();
+#    endif
 }
 void rgblight_timer_enable(void) {
     if (!is_static_effect(rgblight_config.mode)) {
         rgblight_status.timer_enabled = true;
     }
     animation_status.last_timer = sync_timer_read();
+    last_frame_valid            = false;
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+    animation_frame_due = true;
+#    endif
     RGBLIGHT_SPLIT_SET_CHANGE_TIMER_ENABLE;
     dprintf("rgblight timer enabled.\n");
 }
@@ -1053,7 +1180,13 @@ static void rgblight_effect_dummy(animation_status_t *anim) {
 }
 
 void rgblight_timer_task(void) {
-    if (rgblight_status.timer_enabled) {
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+    bool frame_due = animation_frame_due;
+#    else
+    bool frame_due = true;
+#    endif
+
+    if (rgblight_status.timer_enabled && frame_due) {
         effect_func_t effect_func   = rgblight_effect_dummy;
         uint16_t      interval_time = 2000; // dummy interval
         uint8_t       delta         = rgblight_config.mode - rgblight_status.base_mode;
@@ -1127,6 +1260,7 @@ void rgblight_timer_task(void) {
             animation_status.restart    = false;
             animation_status.last_timer = sync_timer_read();
             animation_status.pos16      = 0; // restart signal to local each effect
+            last_frame_valid            = false;
         }
         uint16_t now = sync_timer_read();
         if (timer_expired(now, animation_status.last_timer)) {
@@ -1145,13 +1279,23 @@ void rgblight_timer_task(void) {
             oldpos16 = animation_status.pos16;
 #    endif
             animation_status.last_timer += interval_time;
+            in_effect_frame = true;
             effect_func(&animation_status);
+            in_effect_frame = false;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             if (animation_status.pos16 == 0 && oldpos16 != 0) {
                 tick_flag = true;
             }
 #    endif
         }
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+        // Sleep until the next frame, unless it is due already because the animation is behind
+        now = sync_timer_read();
+        if (!timer_expired(now, animation_status.last_timer)) {
+            animation_frame_due = false;
+            rgblight_animation_timer_schedule(TIMER_DIFF_16(animation_status.last_timer, now));
+        }
+#    endif
     }
 
 #    ifdef RGBLIGHT_LAYERS
@@ -1206,8 +1350,12 @@ __attribute__((weak)) const uint8_t RGBLED_BREATHING_INTERVALS[] PROGMEM = {30,
 
 void rgblight_effect_breathing(animation_status_t *anim) {
     uint8_t val = breathe_calc(anim->pos);
+    anim->pos   = (anim->pos + 1);
+    // The breathe curve holds the same value for several steps around its top and bottom
+    if (rgblight_frame_unchanged(0, val)) {
+        return;
+    }
     rgblight_sethsv_noeeprom_old(rgblight_config.hue, rgblight_config.sat, val);
-    anim->pos = (anim->pos + 1);
 }
 #endif
 
@@ -1228,11 +1376,12 @@ void rgblight_effect_rainbow_mood(animation_status_t *anim) {
 __attribute__((weak)) const uint8_t RGBLED_RAINBOW_SWIRL_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_rainbow_swirl(animation_status_t *anim) {
-    uint8_t hue;
-    uint8_t i;
+    uint8_t        hue;
+    uint8_t        i;
+    const uint8_t *offsets = get_hue_offsets(RGBLIGHT_RAINBOW_SWIRL_RANGE, true);
 
     for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds * i + anim->current_hue);
+        hue = offsets[i] + anim->current_hue;
         sethsv(hue, rgblight_config.sat, rgblight_config.val, (rgb_led_t *)&led[i + rgblight_ranges.effect_start_pos]);
     }
     rgblight_set();
@@ -1277,17 +1426,18 @@ void rgblight_effect_snake(animation_status_t *anim) {
 #    ifdef RGBW
         ledp->w = 0;
 #    endif
-        for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
-            k = pos + j * increment;
-            if (k > RGBLED_NUM) {
-                k = k % (RGBLED_NUM);
-            }
-            if (k < 0) {
-                k = k + rgblight_ranges.effect_num_leds;
-            }
-            if (i == k) {
-                sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val * (RGBLIGHT_EFFECT_SNAKE_LENGTH - j) / RGBLIGHT_EFFECT_SNAKE_LENGTH), ledp);
-            }
+    }
+    // Only the segments of the snake need a colour, rather than checking every LED against every segment
+    for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
+        k = pos + j * increment;
+        if (k > RGBLED_NUM) {
+            k = k % (RGBLED_NUM);
+        }
+        if (k < 0) {
+            k = k + rgblight_ranges.effect_num_leds;
+        }
+        if (k >= 0 && k < rgblight_ranges.effect_num_leds) {
+            sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val * (RGBLIGHT_EFFECT_SNAKE_LENGTH - j) / RGBLIGHT_EFFECT_SNAKE_LENGTH), led + k + rgblight_ranges.effect_start_pos);
         }
     }
     rgblight_set();
@@ -1320,6 +1470,7 @@ void rgblight_effect_knight(animation_status_t *anim) {
     static int8_t high_bound = RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1;
     static int8_t increment  = RGBLIGHT_EFFECT_KNIGHT_INCREMENT;
     uint8_t       i, cur;
+    rgb_led_t     lit;
 
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
     if (anim->pos == 0) { // restart signal
@@ -1338,12 +1489,14 @@ void rgblight_effect_knight(animation_status_t *anim) {
         led[i].w = 0;
 #    endif
     }
+    // All lit LEDs share one colour, so it is only converted once
+    sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, &lit);
     // Determine which LEDs should be lit up
     for (i = 0; i < RGBLIGHT_EFFECT_KNIGHT_LED_NUM; i++) {
         cur = (i + RGBLIGHT_EFFECT_KNIGHT_OFFSET) % rgblight_ranges.effect_num_leds + rgblight_ranges.effect_start_pos;
 
         if (i >= low_bound && i <= high_bound) {
-            sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, (rgb_led_t *)&led[cur]);
+            led[cur] = lit;
         } else {
             led[cur].r = 0;
             led[cur].g = 0;
@@ -1393,18 +1546,23 @@ void rgblight_effect_christmas(animation_status_t *anim) {
     // Additionally, these interpolated colors get shown with a slightly darker value, to make them less prominent than the main colors.
     val = 255 - (3 * (hue < hue_green / 2 ? hue : hue_green - hue) / 2);
 
-    for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        uint8_t local_hue = (i / RGBLIGHT_EFFECT_CHRISTMAS_STEP) % 2 ? hue : hue_green - hue;
-        sethsv(local_hue, rgblight_config.sat, val, (rgb_led_t *)&led[i + rgblight_ranges.effect_start_pos]);
-    }
-    rgblight_set();
-
     if (anim->pos == 0) {
         increment = 1;
     } else if (anim->pos == max_pos) {
         increment = -1;
     }
     anim->pos += increment;
+
+    // The easing lingers on pure red and green, where consecutive frames come out the same
+    if (rgblight_frame_unchanged(hue, val)) {
+        return;
+    }
+
+    for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
+        uint8_t local_hue = (i / RGBLIGHT_EFFECT_CHRISTMAS_STEP) % 2 ? hue : hue_green - hue;
+        sethsv(local_hue, rgblight_config.sat, val, (rgb_led_t *)&led[i + rgblight_ranges.effect_start_pos]);
+    }
+    rgblight_set();
 }
 #endif
 
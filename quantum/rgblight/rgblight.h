@@ -394,6 +394,13 @@ void rgblight_timer_init(void);
 void rgblight_timer_enable(void);
 void rgblight_timer_disable(void);
 void rgblight_timer_toggle(void);
+#    ifdef RGBLIGHT_ANIMATION_TIMER
+/* Platform timer backend: arm a one-shot timer that calls rgblight_animation_timer_expired() after delay_ms */
+void rgblight_animation_timer_init(void);
+void rgblight_animation_timer_schedule(uint16_t delay_ms);
+/* Marks an animation frame as due, safe to call from interrupt context */
+void rgblight_animation_timer_expired(void);
+#    endif
 #else
 #    define rgblight_timer_init()
 #    define rgblight_timer_enable()
@@ -146,15 +146,57 @@ __attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
 // Note: we bit-pack in "reverse" order to optimize loading
 #define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
 
+// Modifiers currently held on behalf of the string being sent. Consecutive characters needing the same modifiers
+// keep them held, rather than pressing and releasing them around every character.
+static uint8_t send_string_mods        = 0;
+static bool    send_string_in_progress = false;
+
+static void send_string_set_mods(uint8_t mods) {
+    uint8_t released = send_string_mods & ~mods;
+    uint8_t pressed  = mods & ~send_string_mods;
+
+    if (released & MOD_BIT(KC_RIGHT_ALT)) {
+        unregister_code(KC_RIGHT_ALT);
+    }
+    if (released & MOD_BIT(KC_LEFT_SHIFT)) {
+        unregister_code(KC_LEFT_SHIFT);
+    }
+    if (pressed & MOD_BIT(KC_LEFT_SHIFT)) {
+        register_code(KC_LEFT_SHIFT);
+    }
+    if (pressed & MOD_BIT(KC_RIGHT_ALT)) {
+        register_code(KC_RIGHT_ALT);
+    }
+
+    send_string_mods = mods;
+}
+
+static bool send_string_begin(void) {
+    bool was_in_progress = send_string_in_progress;
+#ifndef SENDSTRING_NO_MODIFIER_MERGE
+    send_string_in_progress = true;
+#endif
+    return was_in_progress;
+}
+
+static void send_string_end(bool was_in_progress) {
+    send_string_in_progress = was_in_progress;
+    if (!was_in_progress) {
+        send_string_set_mods(0);
+    }
+}
+
 void send_string(const char *string) {
     send_string_with_delay(string, 0);
 }
 
 void send_string_with_delay(const char *string, uint8_t interval) {
+    bool was_in_progress = send_string_begin();
     while (1) {
         char ascii_code = *string;
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+            send_string_set_mods(0);
             ascii_code = *(++string);
             if (ascii_code == SS_TAP_CODE) {
                 // tap
@@ -191,6 +233,7 @@ void send_string_with_delay(const char *string, uint8_t interval) {
                 wait_ms(1);
         }
     }
+    send_string_end(was_in_progress);
 }
 
 void send_char(char ascii_code) {
@@ -206,18 +249,10 @@ void send_char(char ascii_code) {
     bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
     bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
 
-    if (is_shifted) {
-        register_code(KC_LEFT_SHIFT);
-    }
-    if (is_altgred) {
-        register_code(KC_RIGHT_ALT);
-    }
+    send_string_set_mods((is_shifted ? MOD_BIT(KC_LEFT_SHIFT) : 0) | (is_altgred ? MOD_BIT(KC_RIGHT_ALT) : 0));
     tap_code(keycode);
-    if (is_altgred) {
-        unregister_code(KC_RIGHT_ALT);
-    }
-    if (is_shifted) {
-        unregister_code(KC_LEFT_SHIFT);
+    if (is_dead || !send_string_in_progress) {
+        send_string_set_mods(0);
     }
     if (is_dead) {
         tap_code(KC_SPACE);
@@ -284,10 +319,12 @@ void send_string_P(const char *string) {
 }
 
 void send_string_with_delay_P(const char *string, uint8_t interval) {
+    bool was_in_progress = send_string_begin();
     while (1) {
         char ascii_code = pgm_read_byte(string);
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+            send_string_set_mods(0);
             ascii_code = pgm_read_byte(++string);
             if (ascii_code == SS_TAP_CODE) {
                 // tap
@@ -324,5 +361,6 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
                 wait_ms(1);
         }
     }
+    send_string_end(was_in_progress);
 }
 #endif
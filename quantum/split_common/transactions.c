@@ -734,7 +734,11 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
         pointing_device_driver.set_cpi(pointing.cpi);
     }
 
+#    ifdef POINTING_DEVICE_MOTION_INTERRUPT
+    pointing.report = pointing_device_motion_get_report((report_mouse_t){0});
+#    else
     pointing.report = pointing_device_driver.get_report((report_mouse_t){0});
+#    endif
     // Now update the checksum given that the pointing has been written to
     pointing.checksum = crc8(&pointing.report, sizeof(report_mouse_t));
 
@@ -23,6 +23,7 @@ void MockBackingStore::reset_instance() {
     backing_erase_invoke_count  = 0;
     backing_write_invoke_count  = 0;
     backing_lock_invoke_count   = 0;
+    backing_read_invoke_count   = 0;
 
     init_success_callback   = [](std::uint64_t) { return true; };
     erase_success_callback  = [](std::uint64_t) { return true; };
@@ -114,6 +115,8 @@ bool MockBackingStore::lock(void) {
 }
 
 bool MockBackingStore::read(uint32_t address, backing_store_int_t& value) const {
+    ++backing_read_invoke_count;
+
     // precondition: value's buffer size already matches BACKING_STORE_WRITE_SIZE
     EXPECT_TRUE(address % BACKING_STORE_WRITE_SIZE == 0) << "Supplied address was not aligned with the backing store integral size";
     EXPECT_TRUE(address + BACKING_STORE_WRITE_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
@@ -125,6 +128,22 @@ bool MockBackingStore::read(uint32_t address, backing_store_int_t& value) const
     return true;
 }
 
+bool MockBackingStore::read_bulk(uint32_t address, backing_store_int_t* values, std::size_t item_count) const {
+    ++backing_read_invoke_count;
+
+    // precondition: value's buffer size already matches BACKING_STORE_WRITE_SIZE
+    EXPECT_TRUE(address % BACKING_STORE_WRITE_SIZE == 0) << "Supplied address was not aligned with the backing store integral size";
+    EXPECT_TRUE(address + (item_count * BACKING_STORE_WRITE_SIZE) <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
+
+    // Read and take the complement as we're simulating flash memory -- 0xFF means 0x00
+    std::size_t index = address / BACKING_STORE_WRITE_SIZE;
+    for (std::size_t i = 0; i < item_count; ++i) {
+        values[i] = ~backing_storage[index + i].get();
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Backing Implementation
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -152,3 +171,7 @@ extern "C" bool backing_store_lock(void) {
 extern "C" bool backing_store_read(uint32_t address, backing_store_int_t* value) {
     return MockBackingStore::Instance().read(address, *value);
 }
+
+extern "C" bool backing_store_read_bulk(uint32_t address, backing_store_int_t* values, size_t item_count) {
+    return MockBackingStore::Instance().read_bulk(address, values, item_count);
+}
@@ -293,3 +293,37 @@ TEST_F(WearLeveling2ByteOptimizedWrites, PlaybackReadbackWord01_Success) {
     wear_leveling_read(0x02, &tmp, sizeof(tmp));
     EXPECT_EQ(tmp, 1) << "Failed to read back the seeded data";
 }
+
+/**
+ * This test verifies that write log playback fetches the log from the backing store in bulk, such that the number of
+ * backing store read transactions during init scales with the log fill level divided by the playback read count.
+ */
+TEST_F(WearLeveling2ByteOptimizedWrites, PlaybackBulkReadCounts) {
+    auto& inst = MockBackingStore::Instance();
+
+    for (std::size_t fill : {0, 1, 15, 16, 100, 1000, 10000}) {
+        // Clear things out
+        std::fill(verify_data.begin(), verify_data.end(), 0);
+        inst.reset_instance();
+        wear_leveling_init();
+
+        // Each write to an address < 64 results in a single backing store write
+        for (std::size_t i = 0; i < fill; ++i) {
+            uint8_t value = (uint8_t)(i + 1);
+            EXPECT_EQ(test_write(i % 64, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed with incorrect status";
+        }
+
+        // Simulate a reboot
+        std::uint64_t reads_before = inst.read_invoke_count();
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Re-initialisation failed";
+        std::uint64_t reads = inst.read_invoke_count() - reads_before;
+
+        // Consolidated data + checksum, then the log entries plus the terminating empty slot
+        std::size_t expected = 2 + ((fill + 1) + (WEAR_LEVELING_PLAYBACK_READ_COUNT - 1)) / WEAR_LEVELING_PLAYBACK_READ_COUNT;
+        EXPECT_EQ(reads, expected) << "Unexpected backing store read count for fill level " << fill;
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Failed to read back the saved data";
+        EXPECT_TRUE(memcmp(readback.data(), verify_data.data(), WEAR_LEVELING_LOGICAL_SIZE) == 0) << "Readback for fill level " << fill << " did not match";
+    }
+}
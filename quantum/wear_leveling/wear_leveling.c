@@ -61,12 +61,18 @@
             to other subsystems performing reads/writes. This must be a multiple
             of the write size.
 
+        - WEAR_LEVELING_PLAYBACK_READ_COUNT: The number of backing store
+            write-size words fetched in a single bulk read while playing back
+            the write log during initialization. Larger values reduce the
+            number of backing store transactions at the expense of stack usage.
+
     General algorithm:
 
         During initialization:
             * The contents of the consolidated data section are read into cache.
             * The contents of the write log are "played back" and update the
-                cache accordingly.
+                cache accordingly. The write log is fetched from the backing
+                store in bulk, WEAR_LEVELING_PLAYBACK_READ_COUNT words at a time.
 
         During reads:
             * Logical data is served from the cache.
@@ -469,18 +475,52 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
     return status;
 }
 
+/**
+ * Read-ahead buffer used during write log playback.
+ */
+typedef struct wear_leveling_playback_buffer_t {
+    backing_store_int_t values[(WEAR_LEVELING_PLAYBACK_READ_COUNT)];
+    uint32_t            address; // backing store address of values[0]
+    uint32_t            count;   // number of valid entries in values[]
+} wear_leveling_playback_buffer_t;
+
+/**
+ * Reads a single word of the write log, refilling the read-ahead buffer from the backing store in bulk when required.
+ */
+static bool wear_leveling_playback_read(wear_leveling_playback_buffer_t *buffer, uint32_t address, backing_store_int_t *value) {
+    if (address < buffer->address || address >= buffer->address + buffer->count * (BACKING_STORE_WRITE_SIZE)) {
+        if (address >= (WEAR_LEVELING_BACKING_SIZE)) {
+            return false;
+        }
+        uint32_t count = ((WEAR_LEVELING_BACKING_SIZE) - address) / (BACKING_STORE_WRITE_SIZE);
+        if (count > (WEAR_LEVELING_PLAYBACK_READ_COUNT)) {
+            count = (WEAR_LEVELING_PLAYBACK_READ_COUNT);
+        }
+        if (!backing_store_read_bulk(address, buffer->values, count)) {
+            buffer->count = 0;
+            return false;
+        }
+        buffer->address = address;
+        buffer->count   = count;
+    }
+
+    *value = buffer->values[(address - buffer->address) / (BACKING_STORE_WRITE_SIZE)];
+    return true;
+}
+
 /**
  * "Replays" the write log from the backing store, updating the local cache with updated values.
  */
 static wear_leveling_status_t wear_leveling_playback_log(void) {
     wl_dprintf("Playback write log\n");
 
-    wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
-    bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    wear_leveling_playback_buffer_t buffer          = {.address = 0, .count = 0};
+    wear_leveling_status_t          status          = WEAR_LEVELING_SUCCESS;
+    bool                            cancel_playback = false;
+    uint32_t                        address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
     while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
         backing_store_int_t value;
-        bool                ok = backing_store_read(address, &value);
+        bool                ok = wear_leveling_playback_read(&buffer, address, &value);
         if (!ok) {
             wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
             cancel_playback = true;
@@ -509,7 +549,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
         switch (LOG_ENTRY_GET_TYPE(log)) {
             case LOG_ENTRY_TYPE_MULTIBYTE: {
 #if BACKING_STORE_WRITE_SIZE == 2
-                ok = backing_store_read(address, &log.raw16[1]);
+                ok = wear_leveling_playback_read(&buffer, address, &log.raw16[1]);
                 if (!ok) {
                     wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                     cancel_playback = true;
@@ -529,7 +569,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
 #if BACKING_STORE_WRITE_SIZE == 2
                 if (l > 1) {
-                    ok = backing_store_read(address, &log.raw16[2]);
+                    ok = wear_leveling_playback_read(&buffer, address, &log.raw16[2]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -539,7 +579,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                     address += (BACKING_STORE_WRITE_SIZE);
                 }
                 if (l > 3) {
-                    ok = backing_store_read(address, &log.raw16[3]);
+                    ok = wear_leveling_playback_read(&buffer, address, &log.raw16[3]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -550,7 +590,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                 }
 #elif BACKING_STORE_WRITE_SIZE == 4
                 if (l > 1) {
-                    ok = backing_store_read(address, &log.raw32[1]);
+                    ok = wear_leveling_playback_read(&buffer, address, &log.raw32[1]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
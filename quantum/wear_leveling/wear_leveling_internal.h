@@ -27,6 +27,10 @@ typedef uint64_t backing_store_int_t;
 #    error WEAR_LEVELING_LOGICAL_SIZE was not set.
 #endif
 
+#ifndef WEAR_LEVELING_PLAYBACK_READ_COUNT
+#    define WEAR_LEVELING_PLAYBACK_READ_COUNT 16
+#endif // WEAR_LEVELING_PLAYBACK_READ_COUNT
+
 #ifdef WEAR_LEVELING_DEBUG_OUTPUT
 #    include <debug.h>
 #    define bs_dprintf(...) dprintf("Backing store: " __VA_ARGS__)
@@ -65,6 +69,7 @@ typedef uint64_t backing_store_int_t;
 _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "Total backing size must be at least twice the size of the logical size");
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
+_Static_assert(WEAR_LEVELING_PLAYBACK_READ_COUNT > 0, "Playback read count must be nonzero");
 
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
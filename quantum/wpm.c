@@ -20,7 +20,8 @@
 #include "keycode.h"
 #include "quantum_keycodes.h"
 #include "action_util.h"
-#include <math.h>
+#include "util.h"
+#include <string.h>
 
 // WPM Stuff
 static uint8_t  current_wpm = 0;
@@ -34,36 +35,61 @@ static uint32_t wpm_timer   = 0;
  * of the ring buffer can be configured using the keymap configuration
  * value `WPM_SAMPLE_PERIODS`.
  *
+ * The sum over the ring buffer is kept up to date as keys are pressed and
+ * periods expire, and the estimate is only recalculated when a period ends
+ * (or on every counted keypress, with WPM_UNFILTERED), so that decay_wpm()
+ * costs a timer comparison on all other scans.
  */
 #define MAX_PERIODS (WPM_SAMPLE_PERIODS)
 #define PERIOD_DURATION (1000 * WPM_SAMPLE_SECONDS / MAX_PERIODS)
 
 static int16_t period_presses[MAX_PERIODS] = {0};
+static int32_t presses_sum                 = 0;
 static uint8_t current_period              = 0;
 static uint8_t periods                     = 1;
 
 #if !defined(WPM_UNFILTERED)
-/* LATENCY is used as part of filtering, and controls how quickly the reported
- * WPM trails behind our actual instantaneous measured WPM value, and is
- * defined in milliseconds.  So for LATENCY == 100, the displayed WPM is
- * smoothed out over periods of 0.1 seconds.  This results in a nice,
- * smoothly-moving reported WPM value which nevertheless is never more than
- * 0.1 seconds behind the typist's actual current WPM.
+/* The reported WPM follows the measured WPM by exponential smoothing, kept in
+ * 8.8 fixed point: at the end of each period it moves 1/2^WPM_SMOOTHING_SHIFT
+ * of the way to the measured value.  This results in a nice, smoothly-moving
+ * reported WPM value which is never more than a couple of periods behind the
+ * typist's actual current WPM.
  *
- * LATENCY is not used if WPM_UNFILTERED is defined.
+ * Not used if WPM_UNFILTERED is defined.
  */
-#    define LATENCY (100)
-static uint32_t smoothing_timer = 0;
-static uint8_t  prev_wpm        = 0;
-static uint8_t  next_wpm        = 0;
+static uint16_t smoothed_wpm = 0;
 #endif
 
+/* Burst WPM is the rate of the last few keypresses, from an exponential moving
+ * average of the time between them in 1/16 ms.  It drops to zero when no key
+ * has been counted for WPM_BURST_TIMEOUT.
+ */
+static bool     burst_active      = false;
+static uint8_t  burst_wpm         = 0;
+static uint16_t burst_interval_q4 = 0;
+static uint16_t last_press_time   = 0;
+
+/* Per-hand rates are exponentially decaying press counts in 8.8 fixed point,
+ * which settle at 2^WPM_HAND_SMOOTHING_SHIFT times the presses per period.
+ */
+static uint16_t hand_presses[WPM_HAND_COUNT] = {0};
+static uint8_t  hand_wpm[WPM_HAND_COUNT]     = {0};
+
 void set_current_wpm(uint8_t new_wpm) {
     current_wpm = new_wpm;
+#if !defined(WPM_UNFILTERED)
+    smoothed_wpm = (uint16_t)new_wpm << 8;
+#endif
 }
 uint8_t get_current_wpm(void) {
     return current_wpm;
 }
+uint8_t get_burst_wpm(void) {
+    return burst_wpm;
+}
+uint8_t get_hand_wpm(wpm_hand_t hand) {
+    return hand < WPM_HAND_COUNT ? hand_wpm[hand] : 0;
+}
 
 bool wpm_keycode(uint16_t keycode) {
     return wpm_keycode_kb(keycode);
@@ -86,6 +112,21 @@ __attribute__((weak)) bool wpm_keycode_user(uint16_t keycode) {
     return false;
 }
 
+__attribute__((weak)) wpm_hand_t wpm_key_hand(keypos_t key) {
+#ifdef SPLIT_KEYBOARD
+    // The left half always holds the first half of the rows
+    if (key.row < MATRIX_ROWS / 2) {
+        return WPM_HAND_LEFT;
+    }
+    return key.row < MATRIX_ROWS ? WPM_HAND_RIGHT : WPM_HAND_COUNT;
+#else
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return WPM_HAND_COUNT;
+    }
+    return key.col < MATRIX_COLS / 2 ? WPM_HAND_LEFT : WPM_HAND_RIGHT;
+#endif
+}
+
 #if defined(WPM_ALLOW_COUNT_REGRESSION)
 __attribute__((weak)) uint8_t wpm_regress_count(uint16_t keycode) {
     bool weak_modded = (keycode >= QK_LCTL && keycode < QK_LSFT) || (keycode >= QK_RCTL && keycode < QK_RSFT);
@@ -107,45 +148,80 @@ __attribute__((weak)) uint8_t wpm_regress_count(uint16_t keycode) {
 }
 #endif
 
-// Outside 'raw' mode we smooth results over time.
-
-void update_wpm(uint16_t keycode) {
-    if (wpm_keycode(keycode) && period_presses[current_period] < INT16_MAX) {
-        period_presses[current_period]++;
+static void count_press(int16_t change) {
+    int16_t presses = period_presses[current_period];
+    if (change > 0) {
+        change = MIN(change, INT16_MAX - presses);
+    } else {
+        change = MAX(change, INT16_MIN - presses);
     }
-#if defined(WPM_ALLOW_COUNT_REGRESSION)
-    uint8_t regress = wpm_regress_count(keycode);
-    if (regress && period_presses[current_period] > INT16_MIN) {
-        period_presses[current_period]--;
+    period_presses[current_period] = presses + change;
+    presses_sum += change;
+}
+
+static uint8_t measure_wpm(uint32_t elapsed) {
+    // don't guess high WPM based on a single keypress.
+    if (presses_sum < 2) {
+        return 0;
     }
-#endif
+    uint32_t duration = ((periods * PERIOD_DURATION) + elapsed);
+    uint32_t wpm_now  = (60000 * (uint32_t)presses_sum) / (duration * WPM_ESTIMATED_WORD_SIZE);
+
+    // set some reasonable WPM measurement limits
+    return MIN(wpm_now, 240);
 }
 
-void decay_wpm(void) {
-    int32_t presses = period_presses[0];
-    for (int i = 1; i <= periods; i++) {
-        presses += period_presses[i];
+static void update_burst_wpm(void) {
+    uint16_t interval = MAX(timer_elapsed(last_press_time), 1);
+    last_press_time   = timer_read();
+
+    if (!burst_active || interval > WPM_BURST_TIMEOUT) {
+        // first press of a burst, the next one gives its rate
+        burst_active      = true;
+        burst_interval_q4 = 0;
+        burst_wpm         = 0;
+        return;
     }
-    if (presses < 0) {
-        presses = 0;
+
+    if (burst_interval_q4 == 0) {
+        burst_interval_q4 = interval << 4;
+    } else {
+        burst_interval_q4 = (3 * (uint32_t)burst_interval_q4 + ((uint32_t)interval << 4)) >> 2;
     }
-    int32_t  elapsed  = timer_elapsed32(wpm_timer);
-    uint32_t duration = (((periods)*PERIOD_DURATION) + elapsed);
-    int32_t  wpm_now  = (60000 * presses) / (duration * WPM_ESTIMATED_WORD_SIZE);
+    burst_wpm = MIN((60000UL << 4) / ((uint32_t)burst_interval_q4 * WPM_ESTIMATED_WORD_SIZE), 255);
+}
 
-    if (wpm_now < 0) // set some reasonable WPM measurement limits
-        wpm_now = 0;
-    if (wpm_now > 240) wpm_now = 240;
+void update_wpm_key(uint16_t keycode, keypos_t key) {
+    bool counted = wpm_keycode(keycode);
+    if (counted) {
+        count_press(1);
+        update_burst_wpm();
 
-    if (elapsed > PERIOD_DURATION) {
-        current_period                 = (current_period + 1) % MAX_PERIODS;
-        period_presses[current_period] = 0;
-        periods                        = (periods < MAX_PERIODS - 1) ? periods + 1 : MAX_PERIODS - 1;
-        elapsed                        = 0;
-        wpm_timer                      = timer_read32();
+        wpm_hand_t hand = wpm_key_hand(key);
+        if (hand < WPM_HAND_COUNT) {
+            hand_presses[hand] = hand_presses[hand] > UINT16_MAX - 256 ? UINT16_MAX : hand_presses[hand] + 256;
+        }
+    }
+#if defined(WPM_ALLOW_COUNT_REGRESSION)
+    uint8_t regress = wpm_regress_count(keycode);
+    if (regress) {
+        count_press(-(int16_t)regress);
+        counted = true;
     }
-    if (presses < 2) // don't guess high WPM based on a single keypress.
-        wpm_now = 0;
+#endif
+#if defined(WPM_UNFILTERED)
+    if (counted) {
+        current_wpm = measure_wpm(timer_elapsed32(wpm_timer));
+    }
+#endif
+}
+
+void update_wpm(uint16_t keycode) {
+    update_wpm_key(keycode, MAKE_KEYPOS(UINT8_MAX, UINT8_MAX));
+}
+
+static void end_period(uint32_t elapsed) {
+    uint8_t wpm_now = measure_wpm(elapsed);
 
 #if defined(WPM_LAUNCH_CONTROL)
     /*
@@ -155,24 +231,48 @@ void decay_wpm(void) {
      * immediately reach the correct value even before a full sampling buffer
      * has been filled.
      */
-    if (presses == 0) {
-        current_period    = 0;
-        periods           = 0;
-        wpm_now           = 0;
-        period_presses[0] = 0;
-    }
+    if (presses_sum <= 0) {
+        memset(period_presses, 0, sizeof(period_presses));
+        presses_sum    = 0;
+        current_period = 0;
+        periods        = 0;
+    } else
 #endif // WPM_LAUNCH_CONTROL
+    {
+        current_period = (current_period + 1) % MAX_PERIODS;
+        presses_sum -= period_presses[current_period];
+        period_presses[current_period] = 0;
+        periods                        = (periods < MAX_PERIODS - 1) ? periods + 1 : MAX_PERIODS - 1;
+    }
 
 #if defined(WPM_UNFILTERED)
     current_wpm = wpm_now;
 #else
-    int32_t latency = timer_elapsed32(smoothing_timer);
-    if (latency > LATENCY) {
-        smoothing_timer = timer_read32();
-        prev_wpm        = current_wpm;
-        next_wpm        = wpm_now;
+    int32_t target = (int32_t)wpm_now << 8;
+    smoothed_wpm += (target - (int32_t)smoothed_wpm) >> WPM_SMOOTHING_SHIFT;
+    current_wpm = (smoothed_wpm + 128) >> 8;
+#endif
+
+    if (burst_active && timer_elapsed(last_press_time) > WPM_BURST_TIMEOUT) {
+        burst_active = false;
+        burst_wpm    = 0;
     }
 
-    current_wpm = prev_wpm + (latency * ((int)next_wpm - (int)prev_wpm) / LATENCY);
-#endif
+    for (uint8_t hand = 0; hand < WPM_HAND_COUNT; hand++) {
+        // nothing typed for a whole sample, rather than waiting for the long tail of the decay
+        if (presses_sum <= 0) {
+            hand_presses[hand] = 0;
+        }
+        // presses per period, scaled to words per minute
+        hand_wpm[hand] = MIN(((uint32_t)hand_presses[hand] * (60000 / PERIOD_DURATION)) >> (8 + WPM_HAND_SMOOTHING_SHIFT), 255 * WPM_ESTIMATED_WORD_SIZE) / WPM_ESTIMATED_WORD_SIZE;
+        hand_presses[hand] -= hand_presses[hand] >> WPM_HAND_SMOOTHING_SHIFT;
+    }
+}
+
+void decay_wpm(void) {
+    uint32_t elapsed = timer_elapsed32(wpm_timer);
+    if (elapsed > PERIOD_DURATION) {
+        end_period(elapsed);
+        wpm_timer = timer_read32();
+    }
 }
@@ -19,6 +19,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "keyboard.h"
 
 #ifndef WPM_ESTIMATED_WORD_SIZE
 #    define WPM_ESTIMATED_WORD_SIZE 5
@@ -29,17 +30,37 @@
 #ifndef WPM_SAMPLE_PERIODS
 #    define WPM_SAMPLE_PERIODS 25
 #endif
+#ifndef WPM_SMOOTHING_SHIFT
+#    define WPM_SMOOTHING_SHIFT 1
+#endif
+#ifndef WPM_BURST_TIMEOUT
+#    define WPM_BURST_TIMEOUT 1000
+#endif
+#ifndef WPM_HAND_SMOOTHING_SHIFT
+#    define WPM_HAND_SMOOTHING_SHIFT 4
+#endif
+
+typedef enum {
+    WPM_HAND_LEFT,
+    WPM_HAND_RIGHT,
+    WPM_HAND_COUNT, // also returned by wpm_key_hand() for keys that belong to neither hand
+} wpm_hand_t;
 
 bool wpm_keycode(uint16_t keycode);
 bool wpm_keycode_kb(uint16_t keycode);
 bool wpm_keycode_user(uint16_t keycode);
 
+wpm_hand_t wpm_key_hand(keypos_t key);
+
 #ifdef WPM_ALLOW_COUNT_REGRESSION
 uint8_t wpm_regress_count(uint16_t keycode);
 #endif
 
 void    set_current_wpm(uint8_t);
 uint8_t get_current_wpm(void);
+uint8_t get_burst_wpm(void);
+uint8_t get_hand_wpm(wpm_hand_t hand);
 void    update_wpm(uint16_t);
+void    update_wpm_key(uint16_t keycode, keypos_t key);
 
 void decay_wpm(void);
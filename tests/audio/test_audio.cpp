@@ -115,4 +115,35 @@ TEST_F(AudioTest, BpmConversion) {
     }
 }
 
+TEST_F(AudioTest, FrequencyToFixedPoint) {
+    EXPECT_EQ(audio_freq_to_q16(0.0f), 0u);
+    EXPECT_EQ(audio_freq_to_q16(-440.0f), 0u);
+    EXPECT_EQ(audio_freq_to_q16(440.0f), 440u << 16);
+    EXPECT_EQ(audio_freq_to_q16(0.5f), 1u << 15);
+    EXPECT_EQ(audio_freq_to_q16(100000.0f), UINT32_MAX);
+    EXPECT_FLOAT_EQ(AUDIO_FREQ_Q16_TO_FLOAT(audio_freq_to_q16(NOTE_C4)), NOTE_C4);
+}
+
+TEST_F(AudioTest, ProcessedFrequencyIsFixedPoint) {
+    audio_on();
+    audio_stop_all();
+
+    audio_play_tone(NOTE_A4);
+    EXPECT_EQ(audio_get_processed_frequency_q16(0), 440u << 16);
+    EXPECT_FLOAT_EQ(audio_get_processed_frequency(0), NOTE_A4);
+
+    // The most recent tone comes first
+    audio_play_tone(NOTE_C4);
+    EXPECT_EQ(audio_get_processed_frequency_q16(0), audio_freq_to_q16(NOTE_C4));
+    EXPECT_EQ(audio_get_processed_frequency_q16(1), 440u << 16);
+    EXPECT_EQ(audio_get_processed_frequency_q16(2), 0u);
+
+    audio_stop_tone(NOTE_C4);
+    EXPECT_EQ(audio_get_processed_frequency_q16(0), 440u << 16);
+
+    audio_stop_all();
+    EXPECT_EQ(audio_get_processed_frequency_q16(0), 0u);
+    audio_off();
+}
+
 } // namespace
@@ -0,0 +1,158 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+#include "benchmark.hpp"
+
+extern "C" {
+#include "audio.h"
+#include "audio_render.h"
+}
+
+// One second of output
+#define RENDER_SAMPLES AUDIO_RENDER_SAMPLE_RATE
+// One audio tick is one block of samples, followed by audio_update_state()
+#define RENDER_BLOCK_SIZE (AUDIO_DAC_BUFFER_SIZE / 2)
+#define BENCHMARK_ITERATIONS 2000
+
+static const char *voice_names[] = {
+    "default_voice", "vibrating", "something", "drums", "butts_fader", "octave_crunch", "duty_osc", "duty_octave_down", "delayed_vibrato",
+};
+static_assert(sizeof(voice_names) / sizeof(voice_names[0]) == number_of_voices, "voice_names must list every voice");
+
+static float test_melody[][2] = {
+    {NOTE_C5, 8},
+    {NOTE_E5, 8},
+    {NOTE_G5, 16},
+};
+
+class AudioRender : public TestFixture {
+   public:
+    void SetUp() override {
+        audio_on();
+        set_voice(default_voice);
+        silence();
+    }
+
+    void TearDown() override {
+        silence();
+    }
+
+    // Stops whatever is playing, including the startup song, and renders until the output is off
+    void silence() {
+        audio_stop_all();
+        std::vector<uint16_t> samples(RENDER_BLOCK_SIZE * 8);
+        audio_render(samples.data(), samples.size());
+    }
+
+    std::vector<uint16_t> render(size_t count) {
+        std::vector<uint16_t> samples(count);
+        EXPECT_EQ(audio_render(samples.data(), count), count);
+
+        const char *directory = std::getenv("QMK_AUDIO_RENDER_OUTPUT");
+        if (directory) {
+            const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+            std::string                path = std::string(directory) + "/" + info->name() + "_" + std::to_string(files++) + ".wav";
+            EXPECT_TRUE(audio_render_write_wav(path.c_str(), samples.data(), count));
+        }
+        return samples;
+    }
+
+    // Frequency from the upward crossings of AUDIO_DAC_OFF_VALUE, not counting the fade in before the first one
+    static double measure_frequency(const std::vector<uint16_t> &samples) {
+        size_t first = 0, last = 0, cycles = 0;
+        for (size_t i = 1; i < samples.size(); i++) {
+            if (samples[i - 1] < AUDIO_DAC_OFF_VALUE && samples[i] >= AUDIO_DAC_OFF_VALUE) {
+                if (cycles++ == 0) {
+                    first = i;
+                }
+                last = i;
+            }
+        }
+        return cycles < 2 ? 0 : (double)(cycles - 1) * AUDIO_RENDER_SAMPLE_RATE / (last - first);
+    }
+
+    static bool is_silent(const std::vector<uint16_t> &samples, size_t from) {
+        for (size_t i = from; i < samples.size(); i++) {
+            if (samples[i] != AUDIO_DAC_OFF_VALUE) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+   private:
+    unsigned files = 0;
+};
+
+TEST_F(AudioRender, SilentWhenIdle) {
+    EXPECT_TRUE(is_silent(render(RENDER_SAMPLES / 10), 0));
+}
+
+TEST_F(AudioRender, ToneHasPitch) {
+    audio_play_tone(440.0f);
+    auto samples = render(RENDER_SAMPLES);
+
+    EXPECT_NEAR(measure_frequency(samples), 440.0, 0.5);
+    EXPECT_FALSE(is_silent(samples, 0));
+}
+
+TEST_F(AudioRender, ToneStopsAtZero) {
+    audio_play_tone(440.0f);
+    render(RENDER_SAMPLES / 10);
+    audio_stop_tone(440.0f);
+
+    // The output fades out on the next zero crossing, within one period and a few blocks
+    auto samples = render(RENDER_SAMPLES / 10);
+    EXPECT_TRUE(is_silent(samples, RENDER_SAMPLES / 440 + 4 * RENDER_BLOCK_SIZE));
+    EXPECT_FALSE(audio_is_playing_note());
+}
+
+TEST_F(AudioRender, MelodyPlaysToTheEnd) {
+    audio_set_tempo(120);
+    PLAY_SONG(test_melody);
+    EXPECT_TRUE(audio_is_playing_melody());
+
+    // 8 + 8 + 16 sixty-fourths at 120 bpm take 250 ms
+    auto samples = render(RENDER_SAMPLES / 2);
+    EXPECT_FALSE(audio_is_playing_melody());
+    EXPECT_FALSE(is_silent(samples, 0));
+    EXPECT_TRUE(is_silent(samples, RENDER_SAMPLES * 3 / 8));
+}
+
+TEST_F(AudioRender, RenderingIsDeterministic) {
+    audio_set_tempo(120);
+    PLAY_SONG(test_melody);
+    auto first = render(RENDER_SAMPLES / 2);
+    silence();
+
+    PLAY_SONG(test_melody);
+    auto second = render(RENDER_SAMPLES / 2);
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(AudioRender, VoiceBenchmark) {
+    std::vector<uint16_t> block(RENDER_BLOCK_SIZE);
+
+    for (int voice = default_voice; voice < number_of_voices; voice++) {
+        set_voice((voice_type)voice);
+        // Drums pick random pitches
+        srand(1);
+        audio_play_tone(440.0f);
+        audio_play_tone(660.0f);
+
+        // One op is one audio tick: a block of samples and the state update after it
+        BenchmarkResult result = run_benchmark("audio_synth_render", std::string(voice_names[voice]) + ", 2 tones, " + std::to_string(RENDER_BLOCK_SIZE) + " samples/tick", BENCHMARK_ITERATIONS, [&] {
+            audio_render(block.data(), block.size());
+        });
+        std::cout << "[  BENCH   ] " << voice_names[voice] << ": " << (uint64_t)(RENDER_BLOCK_SIZE * 1e9 / result.ns_per_op) << " samples/s" << std::endl;
+
+        silence();
+    }
+}
@@ -0,0 +1,13 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// A full size board, rather than the small matrix used by the other suites
+#define MATRIX_ROWS 6
+#define MATRIX_COLS 21
+
+// Typical of a wear leveled emulated EEPROM on an STM32F4
+#define WEAR_LEVELING_LOGICAL_SIZE 1024
+#define WEAR_LEVELING_BACKING_SIZE 4096
+#define BACKING_STORE_WRITE_SIZE 4
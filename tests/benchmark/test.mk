@@ -0,0 +1,7 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+DEFERRED_EXEC_ENABLE = yes
+
+# The backing store is provided by the benchmarks, in RAM
+WEAR_LEVELING_DRIVER = custom
@@ -0,0 +1,271 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+#include "keycode.h"
+#include "test_common.hpp"
+#include "benchmark.hpp"
+
+extern "C" {
+#include "debounce.h"
+#include "deferred_exec.h"
+#include "host.h"
+#include "wear_leveling.h"
+#include "wear_leveling_internal.h"
+
+void advance_time(uint32_t ms);
+}
+
+// Iterations per benchmark; enough for stable numbers while keeping `make test:all` quick
+#define BENCHMARK_ITERATIONS 20000
+#define BENCHMARK_LAYERS 16
+
+// The bottom row holds a mod-tap key; the typing benchmarks stay clear of it
+#define TYPING_ROWS (MATRIX_ROWS - 1)
+#define MOD_TAP_COL 0
+#define MOD_TAP_ROW (MATRIX_ROWS - 1)
+
+static uint8_t null_keyboard_leds(void) {
+    return 0;
+}
+static void null_send_keyboard(report_keyboard_t *report) {}
+static void null_send_nkro(report_nkro_t *report) {}
+static void null_send_mouse(report_mouse_t *report) {}
+static void null_send_extra(report_extra_t *report) {}
+
+// Reports are discarded, so that gmock bookkeeping is not part of the measurements
+static host_driver_t null_driver = {null_keyboard_leds, null_send_keyboard, null_send_nkro, null_send_mouse, null_send_extra};
+
+static backing_store_int_t backing_store[WEAR_LEVELING_BACKING_SIZE / BACKING_STORE_WRITE_SIZE];
+
+extern "C" bool backing_store_init(void) {
+    return true;
+}
+
+extern "C" bool backing_store_unlock(void) {
+    return true;
+}
+
+extern "C" bool backing_store_erase(void) {
+    memset(backing_store, 0, sizeof(backing_store));
+    return true;
+}
+
+extern "C" bool backing_store_write(uint32_t address, backing_store_int_t value) {
+    backing_store[address / BACKING_STORE_WRITE_SIZE] = value;
+    return true;
+}
+
+extern "C" bool backing_store_lock(void) {
+    return true;
+}
+
+extern "C" bool backing_store_read(uint32_t address, backing_store_int_t *value) {
+    *value = backing_store[address / BACKING_STORE_WRITE_SIZE];
+    return true;
+}
+
+static std::string matrix_params(const std::string &detail) {
+    return std::to_string(MATRIX_ROWS) + "x" + std::to_string(MATRIX_COLS) + " matrix, " + detail;
+}
+
+static keyrecord_t make_record(uint8_t col, uint8_t row, bool pressed, keyevent_type_t type) {
+    keyrecord_t record   = {};
+    record.event.key     = {.col = col, .row = row};
+    record.event.pressed = pressed;
+    record.event.time    = timer_read();
+    record.event.type    = type;
+    return record;
+}
+
+class Benchmark : public TestFixture {
+   public:
+    void SetUp() override {
+        for (uint8_t layer = 0; layer < BENCHMARK_LAYERS; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    uint16_t keycode = layer ? KC_TRNS : KC_A + (row * MATRIX_COLS + col) % 26;
+                    if (layer == 0 && col == MOD_TAP_COL && row == MOD_TAP_ROW) {
+                        keycode = LCTL_T(KC_ESC);
+                    }
+                    add_key(KeymapKey(layer, col, row, keycode));
+                }
+            }
+        }
+
+        saved_debug_config = debug_config;
+        debug_config.raw   = 0;
+        host_set_driver(&null_driver);
+    }
+
+    void TearDown() override {
+        debug_config = saved_debug_config;
+    }
+
+   private:
+    debug_config_t saved_debug_config;
+};
+
+TEST_F(Benchmark, MatrixTaskIdle) {
+    run_benchmark("keyboard_task", matrix_params("no changes"), BENCHMARK_ITERATIONS, [] {
+        keyboard_task();
+        advance_time(1);
+    });
+}
+
+TEST_F(Benchmark, MatrixTaskTyping) {
+    uint16_t key     = 0;
+    bool     pressed = false;
+
+    // Every scan sees one key change, alternating between pressing and releasing a key
+    run_benchmark("keyboard_task", matrix_params("one key change per scan"), BENCHMARK_ITERATIONS, [&] {
+        uint8_t col = key % MATRIX_COLS;
+        uint8_t row = (key / MATRIX_COLS) % TYPING_ROWS;
+        if (pressed) {
+            release_key(col, row);
+            key++;
+        } else {
+            press_key(col, row);
+        }
+        pressed = !pressed;
+        keyboard_task();
+        advance_time(1);
+    });
+
+    clear_all_keys();
+    run_one_scan_loop();
+}
+
+TEST_F(Benchmark, ActionTappingProcessTap) {
+    // One op is a complete tap: press, release within the tapping term, then idle until it expires
+    run_benchmark("action_tapping_process", "mod-tap tapped", BENCHMARK_ITERATIONS, [] {
+        action_tapping_process(make_record(MOD_TAP_COL, MOD_TAP_ROW, true, KEY_EVENT));
+        advance_time(TAPPING_TERM / 4);
+        action_tapping_process(make_record(MOD_TAP_COL, MOD_TAP_ROW, false, KEY_EVENT));
+        advance_time(TAPPING_TERM + 1);
+        action_tapping_process(make_record(0, 0, false, TICK_EVENT));
+    });
+}
+
+TEST_F(Benchmark, ActionTappingProcessHold) {
+    // One op is a complete hold: press, a tick after the tapping term, then release
+    run_benchmark("action_tapping_process", "mod-tap held", BENCHMARK_ITERATIONS, [] {
+        action_tapping_process(make_record(MOD_TAP_COL, MOD_TAP_ROW, true, KEY_EVENT));
+        advance_time(TAPPING_TERM + 1);
+        action_tapping_process(make_record(0, 0, false, TICK_EVENT));
+        action_tapping_process(make_record(MOD_TAP_COL, MOD_TAP_ROW, false, KEY_EVENT));
+        advance_time(1);
+        action_tapping_process(make_record(0, 0, false, TICK_EVENT));
+    });
+}
+
+TEST_F(Benchmark, LayerSwitchGetLayer) {
+    // Every layer above the base is transparent, the worst case for the lookup. Keycodes come from the
+    // test fixture rather than PROGMEM, which adds a hash lookup per layer visited.
+    for (uint8_t layers : {1, 4, 8, 16}) {
+        layer_state_set(((layer_state_t)1 << layers) - 1);
+
+        uint16_t key   = 0;
+        uint8_t  found = 0; // kept live so the lookup is not optimised away, and checked once afterwards
+        run_benchmark("layer_switch_get_layer", matrix_params(std::to_string(layers) + " active layers"), BENCHMARK_ITERATIONS, [&] {
+            keypos_t position = {.col = (uint8_t)(key % MATRIX_COLS), .row = (uint8_t)((key / MATRIX_COLS) % MATRIX_ROWS)};
+            found |= layer_switch_get_layer(position);
+            key++;
+        });
+        EXPECT_EQ(found, 0);
+    }
+    layer_clear();
+}
+
+TEST_F(Benchmark, ReportKeyOps) {
+    for (uint8_t held : {0, 5}) {
+        clear_keys_from_report();
+        // Keys which are already held have to be searched past in the 6KRO report
+        for (uint8_t code = KC_A; code < KC_A + held; code++) {
+            add_key_to_report(code);
+        }
+
+        uint8_t code = KC_F;
+        run_benchmark("add_key_to_report+del_key_from_report", "6KRO, " + std::to_string(held) + " keys held", BENCHMARK_ITERATIONS, [&] {
+            add_key_to_report(code);
+            del_key_from_report(code);
+            code = code == KC_Z ? KC_F : code + 1;
+        });
+
+        clear_keys_from_report();
+    }
+}
+
+TEST_F(Benchmark, Debounce) {
+    matrix_row_t raw[MATRIX_ROWS]    = {};
+    matrix_row_t cooked[MATRIX_ROWS] = {};
+    debounce_init(MATRIX_ROWS);
+
+    run_benchmark("debounce", matrix_params("stable"), BENCHMARK_ITERATIONS, [&] {
+        debounce(raw, cooked, MATRIX_ROWS, false);
+        advance_time(1);
+    });
+
+    uint16_t scan = 0;
+    run_benchmark("debounce", matrix_params("a change every 4 scans"), BENCHMARK_ITERATIONS, [&] {
+        bool changed = scan % 4 == 0;
+        if (changed) {
+            uint16_t key = scan / 4;
+            raw[(key / MATRIX_COLS) % MATRIX_ROWS] ^= (matrix_row_t)1 << (key % MATRIX_COLS);
+        }
+        debounce(raw, cooked, MATRIX_ROWS, changed);
+        advance_time(1);
+        scan++;
+    });
+
+    debounce_free();
+}
+
+static uint32_t repeating_callback(uint32_t trigger_time, void *cb_arg) {
+    (*(uint32_t *)cb_arg)++;
+    return 8;
+}
+
+TEST_F(Benchmark, DeferredExecTask) {
+    run_benchmark("deferred_exec_task", "no executors", BENCHMARK_ITERATIONS, [] {
+        advance_time(1);
+        deferred_exec_task();
+    });
+
+    // Staggered so that one executor fires per millisecond
+    uint32_t       calls = 0;
+    deferred_token tokens[8];
+    for (uint8_t i = 0; i < 8; i++) {
+        tokens[i] = defer_exec(i + 1, repeating_callback, &calls);
+        ASSERT_NE(tokens[i], INVALID_DEFERRED_TOKEN);
+    }
+
+    run_benchmark("deferred_exec_task", "8 repeating executors", BENCHMARK_ITERATIONS, [] {
+        advance_time(1);
+        deferred_exec_task();
+    });
+    EXPECT_GT(calls, 0u);
+
+    for (deferred_token token : tokens) {
+        cancel_deferred_exec(token);
+    }
+}
+
+TEST_F(Benchmark, WearLevelingWrite) {
+    ASSERT_EQ(wear_leveling_erase(), WEAR_LEVELING_SUCCESS);
+
+    for (size_t length : {1, 4}) {
+        uint32_t address = 0;
+        uint32_t value   = 0;
+        // Writes are spread over the logical space, and include the cost of the consolidations they cause
+        std::string params = std::to_string(length) + " byte writes, " + std::to_string(WEAR_LEVELING_LOGICAL_SIZE) + " logical / " + std::to_string(WEAR_LEVELING_BACKING_SIZE) + " backing bytes";
+        run_benchmark("wear_leveling_write", params, BENCHMARK_ITERATIONS, [&] {
+            value++;
+            wear_leveling_write(address, &value, length);
+            address = (address + 36) % (WEAR_LEVELING_LOGICAL_SIZE - length);
+        });
+
+        uint32_t readback = 0;
+        EXPECT_EQ(wear_leveling_read(0, &readback, length), WEAR_LEVELING_SUCCESS);
+    }
+}
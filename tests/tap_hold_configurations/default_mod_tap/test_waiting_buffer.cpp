@@ -0,0 +1,57 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class WaitingBuffer : public TestFixture {};
+
+TEST_F(WaitingBuffer, full_buffer_settles_mod_tap_key_as_held) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    std::vector<KeymapKey> regular_keys;
+    for (uint8_t i = 0; i < WAITING_BUFFER_SIZE; i++) {
+        regular_keys.emplace_back(0, i % MATRIX_COLS, 1 + i / MATRIX_COLS, KC_A + i);
+    }
+
+    add_key(mod_tap_key);
+    for (auto& key : regular_keys) {
+        add_key(key);
+    }
+
+    /* Press mod-tap key. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Tap regular keys within the tapping term until the waiting buffer is full. Every event is reported
+     * once the mod-tap key has been settled as held, and none are lost. */
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    for (auto& key : regular_keys) {
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT, key.report_code));
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    }
+    for (auto& key : regular_keys) {
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap key. */
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
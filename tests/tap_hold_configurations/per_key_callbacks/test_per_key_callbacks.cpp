@@ -0,0 +1,146 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+static int tapping_term_calls;
+static int quick_tap_term_calls;
+static int permissive_hold_calls;
+static int hold_on_other_key_press_calls;
+
+extern "C" {
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    tapping_term_calls++;
+    return keycode == SFT_T(KC_P) ? TAPPING_TERM + 100 : TAPPING_TERM;
+}
+
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+    quick_tap_term_calls++;
+    return QUICK_TAP_TERM;
+}
+
+bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
+    permissive_hold_calls++;
+    return false;
+}
+
+bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
+    hold_on_other_key_press_calls++;
+    return keycode == CTL_T(KC_A);
+}
+}
+
+class PerKeyCallbacks : public TestFixture {
+   public:
+    void SetUp() override {
+        tapping_term_calls            = 0;
+        quick_tap_term_calls          = 0;
+        permissive_hold_calls         = 0;
+        hold_on_other_key_press_calls = 0;
+    }
+};
+
+TEST_F(PerKeyCallbacks, callbacks_are_resolved_once_per_press) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, ALT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    /* Press mod-tap key and hold it past the tapping term. */
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM * 2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(tapping_term_calls, 1);
+    EXPECT_EQ(quick_tap_term_calls, 1);
+    EXPECT_EQ(permissive_hold_calls, 1);
+    EXPECT_EQ(hold_on_other_key_press_calls, 1);
+
+    /* Release mod-tap key. */
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(tapping_term_calls, 1);
+}
+
+TEST_F(PerKeyCallbacks, per_key_tapping_term_is_applied) {
+    TestDriver driver;
+    InSequence s;
+    auto       long_mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       mod_tap_key      = KeymapKey(0, 2, 0, ALT_T(KC_Q));
+
+    set_keymap({long_mod_tap_key, mod_tap_key});
+
+    /* Release the key with the longer tapping term after the default tapping term. */
+    EXPECT_NO_REPORT(driver);
+    long_mod_tap_key.press();
+    idle_for(TAPPING_TERM + 50);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    long_mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    idle_for(TAPPING_TERM + 100);
+
+    /* Do the same with a key using the default tapping term. */
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM + 50);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(PerKeyCallbacks, per_key_hold_on_other_key_press_is_applied) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, CTL_T(KC_A));
+    auto       regular_key = KeymapKey(0, 2, 0, KC_B);
+
+    set_keymap({mod_tap_key, regular_key});
+
+    /* Press mod-tap key. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Press regular key, which settles the mod-tap key as held. */
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_B));
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release regular key. */
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap key. */
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(hold_on_other_key_press_calls, 1);
+}
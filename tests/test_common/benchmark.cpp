@@ -0,0 +1,89 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef __linux__
+#    include <cstring>
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+InstructionCounter::InstructionCounter() {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fd                  = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+InstructionCounter::~InstructionCounter() {
+#ifdef __linux__
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+void InstructionCounter::start() {
+#ifdef __linux__
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+uint64_t InstructionCounter::stop() {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+            count = 0;
+        }
+    }
+#endif
+    return count;
+}
+
+std::ostream& operator<<(std::ostream& stream, const BenchmarkResult& result) {
+    stream << result.name << " (" << result.params << "): " << std::fixed << std::setprecision(1) << result.ns_per_op << " ns/op";
+    if (result.instructions_per_op >= 0) {
+        stream << ", " << result.instructions_per_op << " instructions/op";
+    }
+    stream << std::defaultfloat;
+    return stream;
+}
+
+void report_benchmark(const BenchmarkResult& result) {
+    std::cout << "[  BENCH   ] " << result << std::endl;
+
+    const char* path = std::getenv("QMK_BENCHMARK_OUTPUT");
+    if (!path) {
+        return;
+    }
+
+    // Names and parameters are written by the benchmarks themselves, so need no escaping
+    std::ofstream output(path, std::ios::app);
+    output << std::fixed << std::setprecision(2);
+    output << "{\"name\":\"" << result.name << "\",\"params\":\"" << result.params << "\",\"iterations\":" << result.iterations << ",\"ns_per_op\":" << result.ns_per_op << ",\"instructions_per_op\":";
+    if (result.instructions_per_op >= 0) {
+        output << result.instructions_per_op;
+    } else {
+        output << "null";
+    }
+    output << "}" << std::endl;
+}
@@ -0,0 +1,84 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Counts the user space instructions retired by this thread.
+ *
+ * Uses Linux performance counters where the kernel allows it. Elsewhere, or when
+ * `perf_event_paranoid` forbids access, `available()` is false and only wall time
+ * is measured.
+ */
+class InstructionCounter {
+   public:
+    InstructionCounter();
+    ~InstructionCounter();
+    InstructionCounter(const InstructionCounter&) = delete;
+    InstructionCounter& operator=(const InstructionCounter&) = delete;
+
+    bool available() const {
+        return fd >= 0;
+    }
+    void     start();
+    uint64_t stop();
+
+   private:
+    int fd = -1;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::string params; // e.g. "6x21 matrix, 8 layers"
+    uint64_t    iterations          = 0;
+    double      ns_per_op           = 0;
+    double      instructions_per_op = -1; // negative when instruction counts are unavailable
+};
+
+std::ostream& operator<<(std::ostream& stream, const BenchmarkResult& result);
+
+/**
+ * @brief Prints `result`, and appends it as a JSON line to the file named by
+ * the `QMK_BENCHMARK_OUTPUT` environment variable when that is set.
+ */
+void report_benchmark(const BenchmarkResult& result);
+
+/**
+ * @brief Runs `op` `iterations` times after a short warm up, then reports the
+ * average instructions and wall time per call.
+ *
+ * `op` is inlined into the measured loop, so anything it does besides the code
+ * under test is counted too; keep it to the call being measured and whatever
+ * input rotation it needs.
+ */
+template <typename Op>
+BenchmarkResult run_benchmark(const std::string& name, const std::string& params, uint64_t iterations, Op op) {
+    for (uint64_t i = 0; i < iterations / 10 + 1; i++) {
+        op();
+    }
+
+    InstructionCounter counter;
+    auto               start = std::chrono::steady_clock::now();
+    counter.start();
+    for (uint64_t i = 0; i < iterations; i++) {
+        op();
+    }
+    uint64_t instructions = counter.stop();
+    auto     elapsed      = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    BenchmarkResult result;
+    result.name       = name;
+    result.params     = params;
+    result.iterations = iterations;
+    result.ns_per_op  = (double)elapsed / iterations;
+    if (counter.available()) {
+        result.instructions_per_op = (double)instructions / iterations;
+    }
+    report_benchmark(result);
+    return result;
+}
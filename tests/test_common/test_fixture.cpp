@@ -58,7 +58,8 @@ void TestFixture::TearDownTestCase() {}
 TestFixture::TestFixture() {
     m_this = this;
     timer_clear();
-    test_logger.info() << "tapping term is " << +GET_TAPPING_TERM(KC_TRANSPARENT, &(keyrecord_t){}) << "ms" << std::endl;
+    keyrecord_t record = {};
+    test_logger.info() << "tapping term is " << +GET_TAPPING_TERM(KC_TRANSPARENT, &record) << "ms" << std::endl;
 }
 
 TestFixture::~TestFixture() {
@@ -98,6 +99,7 @@ void TestFixture::add_key(KeymapKey key) {
         FAIL() << "key is already mapped for layer " << +key.layer << " and (column,row) (" << +key.position.col << "," << +key.position.row << ")";
     }
 
+    this->keymap_index[keymap_index_key(key.layer, key.position)] = this->keymap.size();
     this->keymap.push_back(key);
 }
 
@@ -126,18 +128,17 @@ void TestFixture::tap_combo(const std::vector<KeymapKey>& chord_keys, unsigned d
 
 void TestFixture::set_keymap(std::initializer_list<KeymapKey> keys) {
     this->keymap.clear();
+    this->keymap_index.clear();
     for (auto& key : keys) {
         add_key(key);
     }
 }
 
 const KeymapKey* TestFixture::find_key(layer_t layer, keypos_t position) const {
-    auto keymap_key_predicate = [&](KeymapKey candidate) { return candidate.layer == layer && candidate.position.col == position.col && candidate.position.row == position.row; };
+    auto result = this->keymap_index.find(keymap_index_key(layer, position));
 
-    auto result = std::find_if(this->keymap.begin(), this->keymap.end(), keymap_key_predicate);
-
-    if (result != std::end(this->keymap)) {
-        return &(*result);
+    if (result != std::end(this->keymap_index)) {
+        return &this->keymap[result->second];
     }
     return nullptr;
 }
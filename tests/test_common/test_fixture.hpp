@@ -68,4 +68,12 @@ class TestFixture : public testing::Test {
    protected:
     void                   print_test_log() const;
     std::vector<KeymapKey> keymap;
+
+   private:
+    static uint32_t keymap_index_key(const layer_t layer, const keypos_t position) {
+        return (uint32_t)layer << 16 | (uint32_t)position.row << 8 | position.col;
+    }
+
+    /* Position of each key in `keymap`, so that keycode lookups stay cheap for large keymaps. */
+    std::unordered_map<uint32_t, size_t> keymap_index;
 };
@@ -0,0 +1,177 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "trace_replay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "test_matrix.h"
+
+extern "C" {
+#include "debug.h"
+#include "keyboard.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+namespace {
+uint32_t fnv1a(uint32_t hash, uint8_t byte) {
+    return (hash ^ byte) * 16777619u;
+}
+
+// Key order within a report is an implementation detail, so it does not contribute to the hash
+uint32_t hash_report(uint32_t hash, const report_keyboard_t& report) {
+    uint8_t keys[KEYBOARD_REPORT_KEYS];
+    std::copy(std::begin(report.keys), std::end(report.keys), keys);
+    std::sort(std::begin(keys), std::end(keys));
+
+    hash = fnv1a(hash, report.mods);
+    for (uint8_t key : keys) {
+        hash = fnv1a(hash, key);
+    }
+    return hash;
+}
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+KeystrokeTrace KeystrokeTrace::parse(std::istream& stream) {
+    KeystrokeTrace trace;
+    std::string    line;
+    size_t         line_number = 0;
+
+    while (std::getline(stream, line)) {
+        line_number++;
+        std::istringstream fields(line);
+        std::string        first;
+        if (!(fields >> first)) {
+            continue;
+        }
+
+        if (first[0] == '#') {
+            std::string directive, what;
+            if (first == "#" && fields >> directive >> what && directive == "expect") {
+                if (what == "reports") {
+                    trace.has_expected_reports = static_cast<bool>(fields >> trace.expected_reports);
+                } else if (what == "hash") {
+                    trace.has_expected_hash = static_cast<bool>(fields >> std::hex >> trace.expected_hash);
+                }
+            }
+            continue;
+        }
+
+        unsigned   col, row;
+        char       state;
+        TraceEvent event;
+        std::istringstream values(line);
+        if (!(values >> event.time >> col >> row >> state) || col >= MATRIX_COLS || row >= MATRIX_ROWS || (state != 'd' && state != 'u')) {
+            trace.error = "malformed trace event on line " + std::to_string(line_number) + ": " + line;
+            break;
+        }
+        event.col     = col;
+        event.row     = row;
+        event.pressed = state == 'd';
+        trace.events.push_back(event);
+    }
+
+    std::stable_sort(trace.events.begin(), trace.events.end(), [](const TraceEvent& a, const TraceEvent& b) { return a.time < b.time; });
+    return trace;
+}
+
+KeystrokeTrace KeystrokeTrace::load(const std::string& path) {
+    std::ifstream stream(path);
+    if (!stream) {
+        KeystrokeTrace trace;
+        trace.error = "unable to open trace " + path;
+        return trace;
+    }
+    return parse(stream);
+}
+
+uint64_t TraceReplayResult::event_percentile_ns(double percentile) const {
+    if (event_ns.empty()) {
+        return 0;
+    }
+    std::vector<uint64_t> sorted(event_ns);
+    size_t                index = std::min(sorted.size() - 1, (size_t)(percentile / 100.0 * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+std::ostream& operator<<(std::ostream& stream, const TraceReplayResult& result) {
+    stream << result.events << " events, " << result.scans << " scans, " << result.reports << " reports, hash 0x" << std::hex << result.hash << std::dec << "; ";
+    stream << (result.events ? result.total_ns / result.events : 0) << " ns/event overall, event scan p50 " << result.event_percentile_ns(50) << " ns, p99 " << result.event_percentile_ns(99) << " ns, max " << result.event_percentile_ns(100) << " ns";
+    return stream;
+}
+
+TraceReplayResult replay_trace(const KeystrokeTrace& trace, TestDriver& driver, const TraceReplayOptions& options) {
+    TraceReplayResult result;
+    result.event_ns.reserve(trace.events.size());
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([&result](report_keyboard_t& report) {
+        result.reports++;
+        result.hash = hash_report(result.hash, report);
+    }));
+
+    debug_config_t saved_debug_config = debug_config;
+    debug_config.raw                  = 0;
+
+    auto scan = [&result]() {
+        keyboard_task();
+        advance_time(1);
+        result.scans++;
+    };
+
+    auto   replay_start = std::chrono::steady_clock::now();
+    size_t next         = 0;
+    // Trace time of the next scan; gaps longer than max_idle_ms are skipped rather than scanned through
+    uint32_t now = trace.events.empty() ? 0 : trace.events[0].time;
+
+    while (next < trace.events.size()) {
+        uint32_t due = trace.events[next].time;
+        if (due > now + options.max_idle_ms) {
+            now = due - options.max_idle_ms;
+        }
+        while (now < due) {
+            scan();
+            now++;
+        }
+
+        // Events within the same millisecond are seen by the same scan
+        size_t batch_start = next;
+        for (; next < trace.events.size() && trace.events[next].time == due; next++) {
+            const TraceEvent& event = trace.events[next];
+            if (event.pressed) {
+                press_key(event.col, event.row);
+            } else {
+                release_key(event.col, event.row);
+            }
+        }
+
+        auto scan_start = std::chrono::steady_clock::now();
+        scan();
+        now++;
+        uint64_t cost = elapsed_ns(scan_start) / (next - batch_start);
+        result.event_ns.insert(result.event_ns.end(), next - batch_start, cost);
+    }
+
+    // Let any pending taps, combos or timeouts resolve
+    for (uint32_t i = 0; i < options.max_idle_ms; i++) {
+        scan();
+    }
+
+    result.total_ns = elapsed_ns(replay_start);
+    result.events   = trace.events.size();
+
+    debug_config = saved_debug_config;
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    return result;
+}
@@ -0,0 +1,78 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "test_driver.hpp"
+
+/**
+ * @brief A single key state change in a recorded keystroke trace.
+ */
+struct TraceEvent {
+    uint32_t time; // milliseconds since the start of the trace
+    uint8_t  col;
+    uint8_t  row;
+    bool     pressed;
+};
+
+/**
+ * @brief A recorded keystroke timing log, and optionally the output it is expected to produce.
+ *
+ * Traces are plain text, one event per line:
+ *
+ *   <time ms> <col> <row> <d|u>
+ *
+ * Blank lines and lines starting with `#` are ignored, except for the directives
+ * `# expect reports <count>` and `# expect hash <hex>` which record the expected
+ * result of replaying the trace.
+ *
+ * Parsing stops at the first malformed line, leaving a description in `error`.
+ */
+struct KeystrokeTrace {
+    std::vector<TraceEvent> events;
+    bool                    has_expected_reports = false;
+    size_t                  expected_reports     = 0;
+    bool                    has_expected_hash    = false;
+    uint32_t                expected_hash        = 0;
+    std::string             error;
+
+    static KeystrokeTrace parse(std::istream& stream);
+    static KeystrokeTrace load(const std::string& path);
+};
+
+struct TraceReplayOptions {
+    /**
+     * Idle gaps between events are shortened to this many milliseconds, so a full
+     * day of typing can be replayed quickly. It must be longer than any timeout
+     * in the feature set under test, otherwise the output will change.
+     */
+    uint32_t max_idle_ms = 5000;
+};
+
+struct TraceReplayResult {
+    size_t   events  = 0;
+    size_t   scans   = 0;
+    size_t   reports = 0;
+    uint32_t hash    = 2166136261u; // FNV-1a of every keyboard report sent, in order
+
+    uint64_t              total_ns = 0;
+    std::vector<uint64_t> event_ns; // cost of the scan which processed each event
+
+    uint64_t event_percentile_ns(double percentile) const;
+};
+
+std::ostream& operator<<(std::ostream& stream, const TraceReplayResult& result);
+
+/**
+ * @brief Feeds `trace` through the matrix, keyboard_task() and the host driver.
+ *
+ * The active TestFixture provides the keymap. Debug output is suppressed during
+ * the replay so that it does not dominate the measured cost. All keys should be
+ * released by the end of the trace.
+ */
+TraceReplayResult replay_trace(const KeystrokeTrace& trace, TestDriver& driver, const TraceReplayOptions& options = {});
@@ -0,0 +1,117 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdlib>
+#include <sstream>
+#include "keycode.h"
+#include "test_common.hpp"
+#include "trace_replay.hpp"
+
+using testing::_;
+
+class TraceReplay : public TestFixture {
+   public:
+    void SetUp() override {
+        // clang-format off
+        static const uint16_t base[MATRIX_ROWS][MATRIX_COLS] = {
+            {KC_Q,    KC_W,  KC_E,    KC_R,   KC_T,   KC_Y,    KC_U,    KC_I,    KC_O,   KC_P},
+            {LCTL_T(KC_A), KC_S, KC_D, KC_F,  KC_G,   KC_H,    KC_J,    KC_K,    KC_L,   KC_SCLN},
+            {KC_Z,    KC_X,  KC_C,    KC_V,   KC_B,   KC_N,    KC_M,    KC_COMM, KC_DOT, KC_SLSH},
+            {KC_LSFT, MO(1), KC_BSPC, KC_SPC, KC_ENT, KC_QUOT, KC_NO,   KC_NO,   KC_NO,  KC_NO},
+        };
+        static const uint16_t lower[MATRIX_COLS] = {KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0};
+        // clang-format on
+
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                add_key(KeymapKey(0, col, row, base[row][col]));
+            }
+        }
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            add_key(KeymapKey(1, col, 0, lower[col]));
+        }
+
+        autocorrect_enable();
+    }
+};
+
+TEST_F(TraceReplay, ParsesEventsAndExpectations) {
+    std::istringstream stream(
+        "# a comment\n"
+        "# expect reports 4\n"
+        "# expect hash 1f2e3d4c\n"
+        "\n"
+        "120 3 1 u\n"
+        "15 3 1 d\n");
+    KeystrokeTrace trace = KeystrokeTrace::parse(stream);
+
+    EXPECT_EQ(trace.error, "");
+    ASSERT_EQ(trace.events.size(), 2u);
+    // Events are ordered by time
+    EXPECT_EQ(trace.events[0].time, 15u);
+    EXPECT_EQ(trace.events[0].col, 3);
+    EXPECT_EQ(trace.events[0].row, 1);
+    EXPECT_TRUE(trace.events[0].pressed);
+    EXPECT_FALSE(trace.events[1].pressed);
+    EXPECT_TRUE(trace.has_expected_reports);
+    EXPECT_EQ(trace.expected_reports, 4u);
+    EXPECT_TRUE(trace.has_expected_hash);
+    EXPECT_EQ(trace.expected_hash, 0x1f2e3d4cu);
+}
+
+TEST_F(TraceReplay, RejectsMalformedEvents) {
+    std::istringstream bad_state("10 0 0 d\n20 0 0 x\n");
+    KeystrokeTrace     trace = KeystrokeTrace::parse(bad_state);
+    EXPECT_EQ(trace.error, "malformed trace event on line 2: 20 0 0 x");
+    EXPECT_EQ(trace.events.size(), 1u);
+
+    std::istringstream out_of_bounds("10 0 " + std::to_string(MATRIX_ROWS) + " d\n");
+    EXPECT_NE(KeystrokeTrace::parse(out_of_bounds).error, "");
+}
+
+TEST_F(TraceReplay, ReplayIsDeterministic) {
+    TestDriver         driver;
+    std::istringstream stream(
+        "0 6 1 d\n"
+        "4 7 1 d\n"
+        "60 6 1 u\n"
+        "62 7 1 u\n"
+        "300 0 1 d\n"
+        "380 0 1 u\n"
+        "90000 1 0 d\n"
+        "90070 1 0 u\n");
+    KeystrokeTrace trace = KeystrokeTrace::parse(stream);
+
+    TraceReplayResult first  = replay_trace(trace, driver);
+    TraceReplayResult second = replay_trace(trace, driver);
+
+    // Escape from the J+K combo, then A and W: a press and release report each
+    EXPECT_EQ(first.reports, 6u);
+    EXPECT_EQ(first.hash, second.hash);
+    EXPECT_EQ(first.reports, second.reports);
+    EXPECT_EQ(first.events, 8u);
+    EXPECT_EQ(first.event_ns.size(), 8u);
+    // The 90 second gap is shortened rather than scanned through
+    EXPECT_LT(first.scans, 20000u);
+}
+
+// Replays tests/trace_replay/typing.trace, or the trace named by QMK_TRACE_FILE, and reports its cost.
+TEST_F(TraceReplay, ReplaysTypingTrace) {
+    TestDriver  driver;
+    const char* path = std::getenv("QMK_TRACE_FILE");
+    std::string file(__FILE__);
+    std::string trace_path = path ? path : file.substr(0, file.find_last_of('/') + 1) + "typing.trace";
+
+    KeystrokeTrace trace = KeystrokeTrace::load(trace_path);
+    ASSERT_EQ(trace.error, "");
+
+    TraceReplayResult result = replay_trace(trace, driver);
+    std::cout << "[  TRACE   ] " << trace_path << ": " << result << std::endl;
+
+    if (trace.has_expected_reports) {
+        EXPECT_EQ(result.reports, trace.expected_reports);
+    }
+    if (trace.has_expected_hash) {
+        EXPECT_EQ(result.hash, trace.expected_hash) << "output of " << trace_path << " has changed";
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+class Wpm : public TestFixture {
+   public:
+    void SetUp() override {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        // Forget typing from earlier tests
+        idle_for(2 * WPM_SAMPLE_SECONDS * 1000);
+        set_current_wpm(0);
+    }
+
+    // Taps `count` keys, one every `interval` ms, alternating between `left` and `right`
+    void type(KeymapKey left, KeymapKey right, unsigned count, unsigned interval) {
+        for (unsigned i = 0; i < count; i++) {
+            KeymapKey key = i % 2 ? right : left;
+            key.press();
+            run_one_scan_loop();
+            key.release();
+            idle_for(interval - 1);
+        }
+    }
+
+    TestDriver driver;
+    KeymapKey  key_left  = KeymapKey(0, 0, 0, KC_A);
+    KeymapKey  key_right = KeymapKey(0, MATRIX_COLS - 1, 0, KC_L);
+};
+
+TEST_F(Wpm, SteadyTyping) {
+    set_keymap({key_left, key_right});
+
+    // 10 keys a second are 120 words per minute
+    type(key_left, key_right, 2 * WPM_SAMPLE_SECONDS * 10, 100);
+
+    EXPECT_NEAR(get_current_wpm(), 120, 6);
+    EXPECT_NEAR(get_burst_wpm(), 120, 2);
+    EXPECT_NEAR(get_hand_wpm(WPM_HAND_LEFT), 60, 6);
+    EXPECT_NEAR(get_hand_wpm(WPM_HAND_RIGHT), 60, 6);
+}
+
+TEST_F(Wpm, OneHandTyping) {
+    set_keymap({key_left, key_right});
+
+    type(key_left, key_left, 2 * WPM_SAMPLE_SECONDS * 10, 100);
+
+    EXPECT_NEAR(get_hand_wpm(WPM_HAND_LEFT), 120, 12);
+    EXPECT_EQ(get_hand_wpm(WPM_HAND_RIGHT), 0);
+}
+
+TEST_F(Wpm, BurstFollowsRecentKeys) {
+    set_keymap({key_left, key_right});
+
+    type(key_left, key_right, 2 * WPM_SAMPLE_SECONDS * 5, 200);
+    EXPECT_NEAR(get_burst_wpm(), 60, 2);
+
+    // A quick burst shows up in the burst rate well before the average catches up
+    type(key_left, key_right, 10, 50);
+    EXPECT_GT(get_burst_wpm(), 150);
+    EXPECT_LT(get_current_wpm(), 100);
+}
+
+TEST_F(Wpm, DecaysWhenIdle) {
+    set_keymap({key_left, key_right});
+
+    type(key_left, key_right, 2 * WPM_SAMPLE_SECONDS * 10, 100);
+    EXPECT_GT(get_current_wpm(), 0);
+
+    idle_for(WPM_BURST_TIMEOUT + 1000 * WPM_SAMPLE_SECONDS / WPM_SAMPLE_PERIODS);
+    EXPECT_EQ(get_burst_wpm(), 0);
+
+    idle_for(WPM_SAMPLE_SECONDS * 1000 + 1000);
+    EXPECT_EQ(get_current_wpm(), 0);
+    EXPECT_EQ(get_hand_wpm(WPM_HAND_LEFT), 0);
+    EXPECT_EQ(get_hand_wpm(WPM_HAND_RIGHT), 0);
+}
+
+TEST_F(Wpm, IgnoresOtherKeys) {
+    KeymapKey key_enter = KeymapKey(0, 1, 0, KC_ENTER);
+    set_keymap({key_left, key_enter});
+
+    type(key_enter, key_enter, 2 * WPM_SAMPLE_SECONDS * 10, 100);
+
+    EXPECT_EQ(get_current_wpm(), 0);
+    EXPECT_EQ(get_burst_wpm(), 0);
+}
@@ -77,10 +77,6 @@ void raw_hid_task(void);
 #ifdef CONSOLE_ENABLE
 void console_task(void);
 #endif
-#ifdef MIDI_ENABLE
-void midi_ep_task(void);
-#endif
-
 /* TESTING
  * Amber LED blinker thread, times are in milliseconds.
  */
@@ -203,15 +199,16 @@ void protocol_pre_task(void) {
 #    endif /* MOUSEKEY_ENABLE */
     }
 #endif
+
+    usb_sof_sync_task();
 }
 
 void protocol_post_task(void) {
+    usb_sof_slack_task();
+
 #ifdef CONSOLE_ENABLE
     console_task();
 #endif
-#ifdef MIDI_ENABLE
-    midi_ep_task();
-#endif
 #ifdef VIRTSER_ENABLE
     virtser_task();
 #endif
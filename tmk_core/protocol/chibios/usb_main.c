@@ -39,6 +39,8 @@
 #    include "sleep_led.h"
 #    include "led.h"
 #endif
+#include "util.h"
+#include "timer.h"
 #include "wait.h"
 #include "usb_device_state.h"
 #include "usb_descriptor.h"
@@ -128,6 +130,8 @@ static void dummy_usb_cb(USBDriver *usbp, usbep_t ep) {
     (void)ep;
 }
 
+static void report_in_cb(USBDriver *usbp, usbep_t ep);
+
 #ifndef KEYBOARD_SHARED_EP
 /* keyboard endpoint state structure */
 static USBInEndpointState kbd_ep_state;
@@ -135,7 +139,7 @@ static USBInEndpointState kbd_ep_state;
 static const USBEndpointConfig kbd_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    report_in_cb,           /* IN notification callback */
     NULL,                   /* OUT notification callback */
     KEYBOARD_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -153,7 +157,7 @@ static USBInEndpointState mouse_ep_state;
 static const USBEndpointConfig mouse_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    report_in_cb,           /* IN notification callback */
     NULL,                   /* OUT notification callback */
     MOUSE_EPSIZE,           /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -171,7 +175,7 @@ static USBInEndpointState shared_ep_state;
 static const USBEndpointConfig shared_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    report_in_cb,           /* IN notification callback */
     NULL,                   /* OUT notification callback */
     SHARED_EPSIZE,          /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -189,7 +193,7 @@ static USBInEndpointState joystick_ep_state;
 static const USBEndpointConfig joystick_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    report_in_cb,           /* IN notification callback */
     NULL,                   /* OUT notification callback */
     JOYSTICK_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -207,7 +211,7 @@ static USBInEndpointState digitizer_ep_state;
 static const USBEndpointConfig digitizer_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    report_in_cb,           /* IN notification callback */
     NULL,                   /* OUT notification callback */
     DIGITIZER_EPSIZE,       /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -713,8 +717,106 @@ static bool usb_requests_hook_cb(USBDriver *usbp) {
     return false;
 }
 
+/* ---------------------------------------------------------
+ *     Start Of Frame tracking, used to align the matrix
+ *     scan with the host polling interval
+ * ---------------------------------------------------------
+ */
+
+#if defined(USB_SOF_SCAN_SYNC) && (1000000 / CH_CFG_ST_FREQUENCY > USB_SOF_SCAN_LEAD_US / 2)
+/* Sleeps are whole system ticks, which must be fine enough to land within the lead time */
+#    error "USB_SOF_SCAN_SYNC requires a system tick of at most half of USB_SOF_SCAN_LEAD_US, raise CH_CFG_ST_FREQUENCY in chconf.h"
+#endif
+
+#if defined(USB_SOF_SCAN_SYNC) || defined(DEBUG_USB_SOF_SLACK)
+static volatile systime_t sof_timestamp = 0;
+static volatile uint32_t  sof_count     = 0;
+static uint32_t           scan_sof_count;
+
+/* Returns true and the time in microseconds until the next SOF is due, or false if SOFs are not being received */
+static bool usb_sof_time_to_next(int32_t *time_us) {
+    osalSysLock();
+    const systime_t last  = sof_timestamp;
+    const uint32_t  count = sof_count;
+    osalSysUnlock();
+
+    if (count == 0 || USB_DRIVER.state != USB_ACTIVE) {
+        return false;
+    }
+
+    const int32_t elapsed = (int32_t)TIME_I2US(chVTTimeElapsedSinceX(last));
+    if (elapsed >= 2 * USB_SOF_PERIOD_US) {
+        return false;
+    }
+
+    *time_us = USB_SOF_PERIOD_US - elapsed;
+    return true;
+}
+
+void usb_sof_sync_task(void) {
+#    ifdef USB_SOF_SCAN_SYNC
+    int32_t time_to_sof;
+    if (usb_sof_time_to_next(&time_to_sof)) {
+        int32_t sleep_us = time_to_sof - USB_SOF_SCAN_LEAD_US;
+        if (sleep_us <= 0 && scan_sof_count == sof_count) {
+            /* The previous scan already served this frame, so wait for the lead point of the next one */
+            sleep_us += USB_SOF_PERIOD_US;
+        }
+        if (sleep_us > 0) {
+            /* Rounded down to whole ticks, as TIME_US2I() rounds up and would eat into the lead time */
+            sysinterval_t ticks = (sysinterval_t)(((uint64_t)sleep_us * CH_CFG_ST_FREQUENCY) / 1000000);
+            if (ticks > 0) {
+                chThdSleep(ticks);
+            }
+        }
+    }
+#    endif
+    scan_sof_count = sof_count;
+}
+
+#    ifdef DEBUG_USB_SOF_SLACK
+static usb_sof_slack_t slack_current  = {.min = INT16_MAX, .max = INT16_MIN};
+static usb_sof_slack_t slack_last     = {0};
+static int32_t         slack_total    = 0;
+static uint32_t        slack_interval = 0;
+
+void usb_sof_slack_task(void) {
+    int32_t slack;
+    if (usb_sof_time_to_next(&slack)) {
+        if (sof_count != scan_sof_count) {
+            // the scan straddled a frame boundary, so the report missed the poll it was aimed at
+            slack_current.missed++;
+        } else {
+            slack_current.min = MIN(slack_current.min, slack);
+            slack_current.max = MAX(slack_current.max, slack);
+            slack_total += slack;
+            slack_current.count++;
+        }
+    }
+
+    if (timer_elapsed32(slack_interval) >= 1000) {
+        slack_current.avg = slack_current.count ? slack_total / slack_current.count : 0;
+        slack_last        = slack_current;
+        dprintf("sof slack: min %d avg %d max %d us, %lu scans, %lu missed\n", slack_last.min, slack_last.avg, slack_last.max, slack_last.count, slack_last.missed);
+
+        slack_current  = (usb_sof_slack_t){.min = INT16_MAX, .max = INT16_MIN};
+        slack_total    = 0;
+        slack_interval = timer_read32();
+    }
+}
+
+usb_sof_slack_t usb_sof_get_slack(void) {
+    return slack_last;
+}
+#    endif
+#endif
+
 static void usb_sof_cb(USBDriver *usbp) {
     osalSysLockFromISR();
+#if defined(USB_SOF_SCAN_SYNC) || defined(DEBUG_USB_SOF_SLACK)
+    sof_timestamp = chVTGetSystemTimeX();
+    sof_count++;
+#endif
     for (int i = 0; i < NUM_USB_DRIVERS; i++) {
         qmkusbSOFHookI(&drivers.array[i].driver);
     }
@@ -826,35 +928,268 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
-void send_report(uint8_t endpoint, void *report, size_t size) {
+/* ---------------------------------------------------------
+ *                    HID report queues
+ * ---------------------------------------------------------
+ */
+
+/* Reports are queued per endpoint and sent from the IN completion callback, so
+ * that a busy endpoint only stalls the main loop once the queue is full. While
+ * waiting in the queue, mouse reports with unchanged buttons are merged by
+ * summing their movement, and keyboard reports which only release keys are
+ * merged into one another. */
+
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 4
+#endif
+
+typedef enum {
+    REPORT_KIND_RAW,
+    REPORT_KIND_KEYBOARD,
+    REPORT_KIND_NKRO,
+    REPORT_KIND_MOUSE,
+} usb_report_kind_t;
+
+typedef struct {
+    usb_report_kind_t kind;
+    uint8_t           size;
+    union {
+        report_keyboard_t keyboard;
+#ifdef NKRO_ENABLE
+        report_nkro_t nkro;
+#endif
+#ifdef EXTRAKEY_ENABLE
+        report_extra_t extra;
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+        report_programmable_button_t programmable_button;
+#endif
+#ifdef MOUSE_ENABLE
+        report_mouse_t mouse;
+#endif
+#ifdef DIGITIZER_ENABLE
+        report_digitizer_t digitizer;
+#endif
+#ifdef JOYSTICK_ENABLE
+        report_joystick_t joystick;
+#endif
+    } __attribute__((aligned(4))) data;
+} usb_queued_report_t;
+
+#define REPORT_BYTES(queued) ((uint8_t *)&(queued)->data)
+
+typedef struct {
+    uint8_t             endpoint;
+    uint8_t             head;
+    uint8_t             count;
+    thread_reference_t  waiting;   /* sender waiting for a free slot */
+    usb_queued_report_t in_flight; /* last report handed to the USB peripheral */
+    usb_queued_report_t reports[USB_REPORT_QUEUE_SIZE];
+} usb_report_queue_t;
+
+static usb_report_queue_t report_queues[] = {
+#ifndef KEYBOARD_SHARED_EP
+    {.endpoint = KEYBOARD_IN_EPNUM},
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    {.endpoint = MOUSE_IN_EPNUM},
+#endif
+#ifdef SHARED_EP_ENABLE
+    {.endpoint = SHARED_IN_EPNUM},
+#endif
+#if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
+    {.endpoint = JOYSTICK_IN_EPNUM},
+#endif
+#if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
+    {.endpoint = DIGITIZER_IN_EPNUM},
+#endif
+};
+
+#ifdef MOUSE_EXTENDED_REPORT
+#    define REPORT_QUEUE_MOUSE_XY_MIN INT16_MIN
+#    define REPORT_QUEUE_MOUSE_XY_MAX INT16_MAX
+#else
+#    define REPORT_QUEUE_MOUSE_XY_MIN INT8_MIN
+#    define REPORT_QUEUE_MOUSE_XY_MAX INT8_MAX
+#endif
+
+static usb_report_queue_t *report_queue_get(uint8_t endpoint) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(report_queues); ++i) {
+        if (report_queues[i].endpoint == endpoint) {
+            return &report_queues[i];
+        }
+    }
+    return NULL;
+}
+
+static inline usb_queued_report_t *report_queue_tail(usb_report_queue_t *queue, uint8_t offset) {
+    return &queue->reports[(queue->head + queue->count - 1 - offset) % USB_REPORT_QUEUE_SIZE];
+}
+
+/* Returns true if going from `from` to `to` only releases keys. */
+static bool report_queue_is_release(const usb_queued_report_t *from, const usb_queued_report_t *to) {
+    if (to->kind == REPORT_KIND_KEYBOARD) {
+        /* Boot protocol reports start at the modifiers, report protocol ones may have a report ID first */
+        const uint8_t *a = &REPORT_BYTES(from)[from->size - 8];
+        const uint8_t *b = &REPORT_BYTES(to)[to->size - 8];
+        if (b[0] & ~a[0]) {
+            return false;
+        }
+        for (uint8_t i = 2; i < 8; ++i) {
+            if (b[i] && !memchr(&a[2], b[i], 6)) {
+                return false;
+            }
+        }
+        return true;
+    }
+#ifdef NKRO_ENABLE
+    if (to->kind == REPORT_KIND_NKRO) {
+        if (to->data.nkro.mods & ~from->data.nkro.mods) {
+            return false;
+        }
+        for (uint8_t i = 0; i < NKRO_REPORT_BITS; ++i) {
+            if (to->data.nkro.bits[i] & ~from->data.nkro.bits[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+    return false;
+}
+
+/* Attempts to merge the report into the newest queued report. Must be called in locked state. */
+static bool report_queue_coalesce(usb_report_queue_t *queue, const usb_queued_report_t *report) {
+    if (queue->count == 0) {
+        return false;
+    }
+
+    usb_queued_report_t *tail = report_queue_tail(queue, 0);
+    if (tail->kind != report->kind || tail->size != report->size) {
+        return false;
+    }
+
+    /* Mouse movement is relative, so identical reports still need to be summed */
+    if (report->kind != REPORT_KIND_MOUSE && memcmp(REPORT_BYTES(tail), REPORT_BYTES(report), report->size) == 0) {
+        return true;
+    }
+
+    switch (report->kind) {
+#ifdef MOUSE_ENABLE
+        case REPORT_KIND_MOUSE: {
+            /* A tail which presses or releases buttons must keep only the motion made before that edge */
+            const usb_queued_report_t *prev = (queue->count > 1) ? report_queue_tail(queue, 1) : &queue->in_flight;
+            if (prev->kind != tail->kind || prev->size != tail->size || prev->data.mouse.buttons != tail->data.mouse.buttons) {
+                return false;
+            }
+
+            const report_mouse_t *m = &report->data.mouse;
+            report_mouse_t       *t = &tail->data.mouse;
+            int32_t               x = (int32_t)t->x + m->x;
+            int32_t               y = (int32_t)t->y + m->y;
+            int16_t               v = (int16_t)t->v + m->v;
+            int16_t               h = (int16_t)t->h + m->h;
+            if (t->buttons != m->buttons || x < REPORT_QUEUE_MOUSE_XY_MIN || x > REPORT_QUEUE_MOUSE_XY_MAX || y < REPORT_QUEUE_MOUSE_XY_MIN || y > REPORT_QUEUE_MOUSE_XY_MAX || v < INT8_MIN || v > INT8_MAX || h < INT8_MIN || h > INT8_MAX) {
+                return false;
+            }
+            t->x = x;
+            t->y = y;
+            t->v = v;
+            t->h = h;
+#    ifdef MOUSE_EXTENDED_REPORT
+            t->boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+            t->boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#    endif
+            return true;
+        }
+#endif
+        case REPORT_KIND_KEYBOARD:
+        case REPORT_KIND_NKRO: {
+            /* Successive releases can be collapsed, as the host does not need to see the keys released one by one */
+            const usb_queued_report_t *prev = (queue->count > 1) ? report_queue_tail(queue, 1) : &queue->in_flight;
+            if (prev->kind != tail->kind || prev->size != tail->size || !report_queue_is_release(prev, tail) || !report_queue_is_release(tail, report)) {
+                return false;
+            }
+            memcpy(REPORT_BYTES(tail), REPORT_BYTES(report), report->size);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/* Starts transmission of the oldest queued report, if the endpoint is idle. Must be called in locked state. */
+static void report_queue_kick(usb_report_queue_t *queue) {
+    if (queue->count == 0 || usbGetTransmitStatusI(&USB_DRIVER, queue->endpoint)) {
+        return;
+    }
+
+    queue->in_flight = queue->reports[queue->head];
+    queue->head      = (queue->head + 1) % USB_REPORT_QUEUE_SIZE;
+    queue->count--;
+    usbStartTransmitI(&USB_DRIVER, queue->endpoint, REPORT_BYTES(&queue->in_flight), queue->in_flight.size);
+}
+
+/* IN completion callback for report endpoints (called from ISR, unlocked state) */
+static void report_in_cb(USBDriver *usbp, usbep_t ep) {
+    (void)usbp;
+
+    osalSysLockFromISR();
+    usb_report_queue_t *queue = report_queue_get(ep);
+    if (queue != NULL && usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE) {
+        report_queue_kick(queue);
+        osalThreadResumeI(&queue->waiting, MSG_OK);
+    }
+    osalSysUnlockFromISR();
+}
+
+static void send_report_kind(uint8_t endpoint, usb_report_kind_t kind, void *report, size_t size) {
+    usb_report_queue_t *queue = report_queue_get(endpoint);
+    if (queue == NULL || size > sizeof(queue->in_flight.data)) {
+        return;
+    }
+
+    usb_queued_report_t queued = {.kind = kind, .size = size};
+    memcpy(REPORT_BYTES(&queued), report, size);
+
     osalSysLock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+        /* Anything still queued is stale once the host comes back */
+        queue->count = 0;
         osalSysUnlock();
         return;
     }
 
-    if (usbGetTransmitStatusI(&USB_DRIVER, endpoint)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[endpoint]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
+    while (!report_queue_coalesce(queue, &queued)) {
+        if (queue->count < USB_REPORT_QUEUE_SIZE) {
+            queue->count++;
+            *report_queue_tail(queue, 0) = queued;
+            break;
+        }
+        /* Throttle the sender until the host collects a report, as a blocking send would, rather than overwriting a
+         * queued report and losing a key press or mouse movement. Give up if the host has stopped polling. */
+        if (osalThreadSuspendTimeoutS(&queue->waiting, TIME_MS2I(10)) == MSG_TIMEOUT || usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
             osalSysUnlock();
             return;
         }
     }
-    usbStartTransmitI(&USB_DRIVER, endpoint, report, size);
+
+    report_queue_kick(queue);
     osalSysUnlock();
 }
 
+void send_report(uint8_t endpoint, void *report, size_t size) {
+    send_report_kind(endpoint, REPORT_KIND_RAW, report, size);
+}
+
 /* prepare and start sending a report IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
     /* If we're in Boot Protocol, don't send any report ID or other funky fields */
     if (!keyboard_protocol) {
-        send_report(KEYBOARD_IN_EPNUM, &report->mods, 8);
+        send_report_kind(KEYBOARD_IN_EPNUM, REPORT_KIND_KEYBOARD, &report->mods, 8);
     } else {
-        send_report(KEYBOARD_IN_EPNUM, report, KEYBOARD_REPORT_SIZE);
+        send_report_kind(KEYBOARD_IN_EPNUM, REPORT_KIND_KEYBOARD, report, KEYBOARD_REPORT_SIZE);
     }
 
     keyboard_report_sent = *report;
@@ -862,7 +1197,7 @@ void send_keyboard(report_keyboard_t *report) {
 
 void send_nkro(report_nkro_t *report) {
 #ifdef NKRO_ENABLE
-    send_report(SHARED_IN_EPNUM, report, sizeof(report_nkro_t));
+    send_report_kind(SHARED_IN_EPNUM, REPORT_KIND_NKRO, report, sizeof(report_nkro_t));
 #endif
 }
 
@@ -873,7 +1208,7 @@ void send_nkro(report_nkro_t *report) {
 
 void send_mouse(report_mouse_t *report) {
 #ifdef MOUSE_ENABLE
-    send_report(MOUSE_IN_EPNUM, report, sizeof(report_mouse_t));
+    send_report_kind(MOUSE_IN_EPNUM, REPORT_KIND_MOUSE, report, sizeof(report_mouse_t));
     mouse_report_sent = *report;
 #endif
 }
@@ -1001,16 +1336,15 @@ bool recv_midi_packet(MIDI_EventPacket_t *const event) {
     size_t size = chnReadTimeout(&drivers.midi_driver.driver, (uint8_t *)event, sizeof(MIDI_EventPacket_t), TIME_IMMEDIATE);
     return size == sizeof(MIDI_EventPacket_t);
 }
-void midi_ep_task(void) {
-    uint8_t buffer[MIDI_STREAM_EPSIZE];
-    size_t  size = 0;
-    do {
-        size = chnReadTimeout(&drivers.midi_driver.driver, buffer, sizeof(buffer), TIME_IMMEDIATE);
-        if (size > 0) {
-            MIDI_EventPacket_t event;
-            recv_midi_packet(&event);
-        }
-    } while (size > 0);
+
+void send_midi_packets(MIDI_EventPacket_t *events, uint8_t count) {
+    chnWrite(&drivers.midi_driver.driver, (uint8_t *)events, count * sizeof(MIDI_EventPacket_t));
+}
+
+uint8_t recv_midi_packets(MIDI_EventPacket_t *const events, uint8_t max_count) {
+    // the host sends whole packets, and only whole packets are read, so reads stay aligned to them
+    size_t size = chnReadTimeout(&drivers.midi_driver.driver, (uint8_t *)events, max_count * sizeof(MIDI_EventPacket_t), TIME_IMMEDIATE);
+    return size / sizeof(MIDI_EventPacket_t);
 }
 #endif
 
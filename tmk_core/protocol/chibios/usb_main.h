@@ -47,6 +47,51 @@ void usb_event_queue_init(void);
 /* Task to dequeue and execute any handlers for the USB events on the main thread */
 void usb_event_queue_task(void);
 
+/* ---------------------------
+ * Start Of Frame synchronisation
+ * ---------------------------
+ */
+
+/* Duration of a full-speed USB frame */
+#ifndef USB_SOF_PERIOD_US
+#    define USB_SOF_PERIOD_US 1000
+#endif
+
+/* Time reserved before the next SOF to scan the matrix and queue the resulting reports */
+#ifndef USB_SOF_SCAN_LEAD_US
+#    define USB_SOF_SCAN_LEAD_US 250
+#endif
+
+#if defined(USB_SOF_SCAN_SYNC) || defined(DEBUG_USB_SOF_SLACK)
+
+/* Delay the start of the next scan until USB_SOF_SCAN_LEAD_US before the next SOF */
+void usb_sof_sync_task(void);
+
+#else
+#    define usb_sof_sync_task()
+#endif
+
+#ifdef DEBUG_USB_SOF_SLACK
+
+/* Time left between the end of a scan and the next SOF, gathered over one second */
+typedef struct {
+    int16_t  min;
+    int16_t  avg;
+    int16_t  max;
+    uint32_t count;
+    uint32_t missed;
+} usb_sof_slack_t;
+
+/* Record the slack of the scan that just finished */
+void usb_sof_slack_task(void);
+
+/* Statistics for the previous one second period */
+usb_sof_slack_t usb_sof_get_slack(void);
+
+#else
+#    define usb_sof_slack_task()
+#endif
+
 /* --------------
  * Console header
  * --------------
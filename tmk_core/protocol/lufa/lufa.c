@@ -712,6 +712,23 @@ bool recv_midi_packet(MIDI_EventPacket_t *const event) {
     return MIDI_Device_ReceiveEventPacket(&USB_MIDI_Interface, event);
 }
 
+void send_midi_packets(MIDI_EventPacket_t *events, uint8_t count) {
+    // packets fill the endpoint bank, which is sent once full or by MIDI_Device_USBTask()
+    for (uint8_t i = 0; i < count; i++) {
+        if (MIDI_Device_SendEventPacket(&USB_MIDI_Interface, &events[i]) != ENDPOINT_RWSTREAM_NoError) {
+            return;
+        }
+    }
+}
+
+uint8_t recv_midi_packets(MIDI_EventPacket_t *const events, uint8_t max_count) {
+    uint8_t count = 0;
+    while (count < max_count && MIDI_Device_ReceiveEventPacket(&USB_MIDI_Interface, &events[count])) {
+        count++;
+    }
+    return count;
+}
+
 #endif
 
 /*******************************************************************************